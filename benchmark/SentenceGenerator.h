@@ -0,0 +1,68 @@
+#ifndef SENTENCE_GENERATOR_H
+#define SENTENCE_GENERATOR_H
+
+#include "../src/Grammar.h"
+#include <algorithm>
+#include <climits>
+#include <random>
+#include <vector>
+
+// random sentences of a grammar. past maxDepth only the productions with the lowest derivation
+// height are taken, so every sentence ends.
+class SentenceGenerator {
+public:
+    SentenceGenerator(const Grammar &grammarRef, unsigned seed, int depthLimit)
+            : grammar(grammarRef), random{seed}, maxDepth{depthLimit} {
+        height.assign(grammar.symbolBound(), INT_MAX);
+        for (auto symbol : grammar.terminals()) {
+            height[symbol] = 0;
+        }
+        height[grammar.epsilon()] = 0;
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (int p = 0; p < static_cast<int>(grammar.productionCount()); p++) {
+                int h = productionHeight(p);
+                if (h != INT_MAX && h + 1 < height[grammar.lhs(p)]) {
+                    height[grammar.lhs(p)] = h + 1;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    void generate(int symbol, std::vector<int> &tokens, int depth = 0) {
+        if (symbol == grammar.epsilon()) {
+            return;
+        }
+        if (grammar.isTerminal(symbol)) {
+            tokens.push_back(symbol);
+            return;
+        }
+        auto &productions = grammar.productionsOf(symbol);
+        int chosen = productions[random() % productions.size()];
+        if (depth > maxDepth) {
+            chosen = *std::min_element(productions.begin(), productions.end(), [this](int a, int b) {
+                return productionHeight(a) < productionHeight(b);
+            });
+        }
+        for (auto next : grammar.rhs(chosen)) {
+            generate(next, tokens, depth + 1);
+        }
+    }
+
+private:
+    int productionHeight(int production) const {
+        int result = 0;
+        for (auto symbol : grammar.rhs(production)) {
+            result = std::max(result, height[symbol]);
+        }
+        return result;
+    }
+
+    const Grammar &grammar;
+    std::mt19937 random;
+    int maxDepth;
+    std::vector<int> height;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef SYNTHETIC_GRAMMAR_H
+#define SYNTHETIC_GRAMMAR_H
+
+#include "../src/Context.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// random grammars of a given shape for scaling the generator, built like the statements of a
+// programming language: every alternative but the left recursive one starts with a terminal and only
+// refers to the next `window` no terminals, so the number of lr(1) states grows with the grammar instead
+// of exploding. the first alternative of Ni refers to Ni+1, so all of them are reachable, and only to later
+// no terminals, so every no terminal derives a sentence
+struct SyntheticShape {
+    int noTerminals = 50;
+    int terminals = 20;
+    // alternatives per no terminal
+    int branching = 3;
+    // the longest right hand side, the length of each is uniform in [1, maxLength]
+    int maxLength = 4;
+    // how far ahead an alternative may refer to another no terminal
+    int window = 4;
+    // the share of no terminals with an ε alternative
+    double epsilonDensity = 0.1;
+    // the share of no terminals with a left recursive alternative A ::= A ...
+    double leftRecursion = 0.2;
+    unsigned seed = 1;
+
+    std::string name() const {
+        return "synthetic(n=" + std::to_string(noTerminals) + ",t=" + std::to_string(terminals) + ",b=" +
+               std::to_string(branching) + ",len=" + std::to_string(maxLength) + ",eps=" +
+               std::to_string(epsilonDensity).substr(0, 4) + ",left=" + std::to_string(leftRecursion).substr(0, 4) +
+               ")";
+    }
+};
+
+inline std::vector<Production> syntheticGrammar(const SyntheticShape &shape) {
+    std::mt19937 random{shape.seed};
+    std::uniform_real_distribution<double> chance{0, 1};
+    std::vector<Item> noTerminals{};
+    for (int i = 0; i < shape.noTerminals; i++) {
+        noTerminals.emplace_back("N" + std::to_string(i), ItemType::NoTerminal);
+    }
+    std::vector<Item> terminals{};
+    for (int i = 0; i < shape.terminals; i++) {
+        terminals.emplace_back("t" + std::to_string(i), ItemType::Terminal);
+    }
+    Item empty{"000", ItemType::Terminal};
+    auto terminal = [&]() { return terminals[random() % terminals.size()]; };
+    std::vector<Production> result{
+            Production{Item{"N_start", ItemType::NoTerminal}, std::vector<Item>{noTerminals[0]}},
+    };
+    for (int i = 0; i < shape.noTerminals; i++) {
+        auto &lhs = noTerminals[i];
+        // the alternatives of a no terminal start with different terminals, like keywords
+        std::vector<Item> leaders{terminals};
+        std::shuffle(leaders.begin(), leaders.end(), random);
+        for (int alternative = 0; alternative < shape.branching; alternative++) {
+            int length = 1 + static_cast<int>(random() % shape.maxLength);
+            std::vector<Item> rhs{};
+            if (alternative == 1 && chance(random) < shape.leftRecursion) {
+                rhs.push_back(lhs);
+                rhs.push_back(terminal());
+            }
+            if (rhs.empty()) {
+                rhs.push_back(leaders[alternative % leaders.size()]);
+            }
+            if (alternative == 0 && i + 1 < shape.noTerminals) {
+                rhs.push_back(noTerminals[i + 1]);
+            }
+            while (static_cast<int>(rhs.size()) < length) {
+                int next = i + 1 + static_cast<int>(random() % shape.window);
+                if (random() % 2 == 0 || next >= shape.noTerminals) {
+                    rhs.push_back(terminal());
+                } else {
+                    rhs.push_back(noTerminals[next]);
+                }
+            }
+            result.emplace_back(lhs, rhs);
+        }
+        if (chance(random) < shape.epsilonDensity) {
+            result.emplace_back(lhs, std::vector<Item>{empty});
+        }
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,18 @@
+#include "../../src/Context.h"
+#include "../../src/DirectCode.h"
+#include "../../test/lua/LuaGrammar.h"
+#include <fstream>
+
+// writes the directly coded parser of the lua grammar to the header given as argument
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        return 1;
+    }
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    auto states = context.generateLr1Parallel();
+    auto table = context.table(states);
+    std::ofstream out{argv[1]};
+    out << DirectCodeGenerator{table, Item{"$", ItemType::Terminal}.getId()}.generate("lua_direct");
+    return out ? 0 : 1;
+}
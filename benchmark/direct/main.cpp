@@ -0,0 +1,75 @@
+#include "../../src/Context.h"
+#include "../../src/LrParser.h"
+#include "../../test/lua/LuaGrammar.h"
+#include "../SentenceGenerator.h"
+#include "LuaDirect.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+// parses the same synthetic lua program with LrParser and with the directly coded parser generated
+// from the same table. the direct time includes mapping the symbol ids to terminal columns, which
+// LrParser does per token. the first argument is the number of tokens.
+int main(int argc, char *argv[]) {
+    size_t target = argc > 1 ? static_cast<size_t>(::atol(argv[1])) : 1000000;
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    auto states = context.generateLr1Parallel();
+    auto table = context.table(states);
+    if (lua_direct::terminalCount != static_cast<int>(table.terminalCount())) {
+        ::fprintf(stderr, "LuaDirect.h does not match the lua grammar\n");
+        return 1;
+    }
+    LrParser parser{table, Item{"$", ItemType::Terminal}.getId()};
+
+    SentenceGenerator generator{context.getGrammar(), 42, 12};
+    vector<int> tokens{};
+    vector<int> statement{};
+    while (tokens.size() < target) {
+        statement.clear();
+        generator.generate(lua.stat.getId(), statement);
+        // a statement starting with ( would continue the expression before it
+        if (statement.front() == lua.l_bracket.getId() || !parser.parse(statement).accepted) {
+            continue;
+        }
+        tokens.insert(tokens.end(), statement.begin(), statement.end());
+    }
+
+    size_t tableReductions = 0;
+    parser.onReduce([&tableReductions](int, size_t, size_t) { tableReductions++; });
+    size_t directReductions = 0;
+    vector<int> columns(tokens.size());
+    vector<int> stateStack(256);
+    vector<size_t> startStack(256);
+    double tableBest = 0;
+    double directBest = 0;
+    ParseResult tableResult{};
+    lua_direct::Result directResult{};
+    for (int round = 0; round < 5; round++) {
+        tableReductions = 0;
+        auto begin = chrono::steady_clock::now();
+        tableResult = parser.parse(tokens);
+        auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        tableBest = round == 0 ? elapsed : std::min(tableBest, elapsed);
+
+        directReductions = 0;
+        begin = chrono::steady_clock::now();
+        for (size_t i = 0; i < tokens.size(); i++) {
+            columns[i] = table.terminalColumn(tokens[i]);
+        }
+        directResult = lua_direct::parse(columns.data(), columns.size(), stateStack, startStack,
+                                         [&directReductions](int, size_t, size_t) { directReductions++; });
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+        directBest = round == 0 ? elapsed : std::min(directBest, elapsed);
+    }
+    ::printf("%10s %12s %10s %12s %14s %12s\n", "parser", "tokens", "accepted", "time(ms)", "tokens/s",
+             "reductions");
+    ::printf("%10s %12zu %10s %12.2f %14.0f %12zu\n", "table", tokens.size(), tableResult.accepted ? "yes" : "no",
+             tableBest * 1000, tokens.size() / tableBest, tableReductions);
+    ::printf("%10s %12zu %10s %12.2f %14.0f %12zu\n", "direct", tokens.size(), directResult.accepted ? "yes" : "no",
+             directBest * 1000, tokens.size() / directBest, directReductions);
+    ::printf("speedup %.2fx\n", tableBest / directBest);
+    return tableResult.accepted && directResult.accepted && tableReductions == directReductions ? 0 : 1;
+}
@@ -0,0 +1,164 @@
+#include "../../src/Context.h"
+#include "../../src/GrammarFile.h"
+#include "../../src/Quote.h"
+#include "../../test/lua/LuaGrammar.h"
+#include "../SyntheticGrammar.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+// times first(), follow(), generalLr1() and table() one by one on the test grammars and on synthetic
+// grammars growing in one dimension at a time, and writes the results as json.
+// usage: generator_benchmark [--repeat n] [--quick] [output.json], stdout without a file
+namespace {
+
+struct Phases {
+    double first;
+    double follow;
+    double lr1;
+    double table;
+};
+
+struct Measurement {
+    string name;
+    string group;
+    size_t productions;
+    size_t states;
+    size_t conflicts;
+    Phases best;
+    Phases median;
+};
+
+double since(chrono::steady_clock::time_point begin) {
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+}
+
+Measurement measure(const string &group, const string &name, const vector<Production> &productions, int repeat) {
+    vector<Phases> runs{};
+    size_t states = 0;
+    size_t conflicts = 0;
+    for (int round = 0; round < repeat; round++) {
+        // a fresh context every round, nothing is cached between the rounds
+        Context context{productions, productions[0]};
+        Phases phases{};
+        auto begin = chrono::steady_clock::now();
+        context.first();
+        phases.first = since(begin);
+        begin = chrono::steady_clock::now();
+        context.follow();
+        phases.follow = since(begin);
+        begin = chrono::steady_clock::now();
+        auto stateSet = context.generalLr1();
+        phases.lr1 = since(begin);
+        begin = chrono::steady_clock::now();
+        context.table(stateSet);
+        phases.table = since(begin);
+        runs.push_back(phases);
+        states = stateSet.size();
+        conflicts = context.getConflicts().size();
+    }
+    auto pick = [&runs](double Phases::*phase, bool median) {
+        vector<double> values{};
+        for (auto &run : runs) {
+            values.push_back(run.*phase);
+        }
+        std::sort(values.begin(), values.end());
+        return median ? values[values.size() / 2] : values.front();
+    };
+    Measurement result{name, group, productions.size(), states, conflicts, {}, {}};
+    for (auto median : {false, true}) {
+        auto &phases = median ? result.median : result.best;
+        phases = Phases{pick(&Phases::first, median), pick(&Phases::follow, median), pick(&Phases::lr1, median),
+                        pick(&Phases::table, median)};
+    }
+    ::fprintf(stderr, "%-13s %-58s %8zu %8zu %10.3f %10.3f %10.3f %10.3f\n", group.c_str(), name.c_str(),
+              productions.size(), states, result.best.first, result.best.follow, result.best.lr1,
+              result.best.table);
+    return result;
+}
+
+void writePhases(ostream &out, const Phases &phases) {
+    out << "{\"first\": " << phases.first << ", \"follow\": " << phases.follow << ", \"lr1\": " << phases.lr1
+        << ", \"table\": " << phases.table << "}";
+}
+
+}
+
+int main(int argc, char *argv[]) {
+    int repeat = 5;
+    bool quick = false;
+    string output{};
+    for (int i = 1; i < argc; i++) {
+        if (::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = std::max(1, ::atoi(argv[++i]));
+        } else if (::strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else {
+            output = argv[i];
+        }
+    }
+
+    ::fprintf(stderr, "%-13s %-58s %8s %8s %10s %10s %10s %10s\n", "group", "grammar", "rules", "states",
+              "first(ms)", "follow(ms)", "lr1(ms)", "table(ms)");
+    vector<Measurement> results{};
+    auto fixed = [&](const string &name, const string &text) {
+        auto grammar = GrammarFile::parse(text, name);
+        results.push_back(measure("fixed", name, grammar.productions(), repeat));
+    };
+    fixed("example", "E ::= T E_\nE_ ::= + T E_ | ε\nT ::= F T_\nT_ ::= * F T_ | ε\nF ::= ( E ) | i\n");
+    fixed("closure", "S ::= E\nE ::= E + T | T\nT ::= i\n");
+    fixed("goto", "S_ ::= S\nS ::= C C\nC ::= c C | d\n");
+    LuaGrammar lua{};
+    results.push_back(measure("fixed", "lua", lua.productionList, repeat));
+
+    // each sweep grows one dimension of the default shape
+    vector<int> sizes = quick ? vector<int>{25, 50} : vector<int>{25, 50, 100, 200, 400};
+    for (auto n : sizes) {
+        SyntheticShape shape{};
+        shape.noTerminals = n;
+        results.push_back(measure("noTerminals", shape.name(), syntheticGrammar(shape), repeat));
+    }
+    for (auto b : quick ? vector<int>{2, 4} : vector<int>{2, 3, 4, 6, 8}) {
+        SyntheticShape shape{};
+        shape.branching = b;
+        results.push_back(measure("branching", shape.name(), syntheticGrammar(shape), repeat));
+    }
+    for (auto eps : quick ? vector<double>{0, 0.5} : vector<double>{0, 0.1, 0.25, 0.5, 0.75}) {
+        SyntheticShape shape{};
+        shape.epsilonDensity = eps;
+        results.push_back(measure("epsilon", shape.name(), syntheticGrammar(shape), repeat));
+    }
+    for (auto left : quick ? vector<double>{0, 1} : vector<double>{0, 0.25, 0.5, 0.75, 1}) {
+        SyntheticShape shape{};
+        shape.leftRecursion = left;
+        results.push_back(measure("leftRecursion", shape.name(), syntheticGrammar(shape), repeat));
+    }
+
+    ostringstream json{};
+    json << "{\n  \"repeat\": " << repeat << ",\n  \"unit\": \"ms\",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        auto &result = results[i];
+        json << "    {\"group\": " << quote(result.group) << ", \"grammar\": " << quote(result.name)
+             << ", \"productions\": " << result.productions << ", \"states\": " << result.states
+             << ", \"conflicts\": " << result.conflicts << ",\n     \"best\": ";
+        writePhases(json, result.best);
+        json << ",\n     \"median\": ";
+        writePhases(json, result.median);
+        json << "}" << (i + 1 == results.size() ? "\n" : ",\n");
+    }
+    json << "  ]\n}\n";
+    if (output.empty()) {
+        cout << json.str();
+        return 0;
+    }
+    std::ofstream out{output};
+    out << json.str();
+    return out ? 0 : 1;
+}
@@ -0,0 +1,87 @@
+#include "../../src/Context.h"
+#include "../../src/Lexer.h"
+#include "../../src/LrParser.h"
+#include "../../test/lua/LuaGrammar.h"
+#include "../../test/lua/LuaLexer.h"
+#include "../SentenceGenerator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+// renders a synthetic lua program as text, then times the lexer with and without the vectorized
+// run skipping and the lexer followed by LrParser. the first argument is the number of tokens.
+int main(int argc, char *argv[]) {
+    size_t target = argc > 1 ? static_cast<size_t>(::atol(argv[1])) : 1000000;
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    auto states = context.generateLr1Parallel();
+    auto table = context.table(states);
+    LrParser parser{table, Item{"$", ItemType::Terminal}.getId()};
+    auto lexerTable = LexerGenerator{luaTokenRules()}.generate();
+    Lexer lexer{lexerTable};
+
+    SentenceGenerator generator{context.getGrammar(), 42, 12};
+    mt19937 random{7};
+    vector<int> tokens{};
+    vector<int> statement{};
+    string text{};
+    auto word = [&random](size_t length) {
+        string result{"v_"};
+        for (size_t i = 0; i < length; i++) {
+            result.push_back("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_"[random() % 63]);
+        }
+        return result;
+    };
+    while (tokens.size() < target) {
+        statement.clear();
+        generator.generate(lua.stat.getId(), statement);
+        if (statement.front() == lua.l_bracket.getId() || !parser.parse(statement).accepted) {
+            continue;
+        }
+        for (auto symbol : statement) {
+            if (symbol == lua.name.getId()) {
+                text += word(random() % 16);
+            } else if (symbol == lua.number_.getId()) {
+                text += to_string(random());
+            } else if (symbol == lua.string_.getId()) {
+                text += "\"" + string(random() % 40, 's') + "\"";
+            } else {
+                text += Item{symbol}.getName();
+            }
+            text += random() % 8 == 0 ? "\n    " : " ";
+        }
+        text += "\n";
+        tokens.insert(tokens.end(), statement.begin(), statement.end());
+    }
+
+    vector<int> symbols{};
+    symbols.reserve(tokens.size());
+    double best[3] = {0, 0, 0};
+    bool same = true;
+    bool accepted = true;
+    for (int round = 0; round < 5; round++) {
+        for (int mode = 0; mode < 3; mode++) {
+            lexer.setVectorized(mode != 1);
+            symbols.clear();
+            auto begin = chrono::steady_clock::now();
+            auto result = lexer.tokenize(text, symbols);
+            if (mode == 2) {
+                accepted = accepted && parser.parse(symbols).accepted;
+            }
+            auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            best[mode] = round == 0 ? elapsed : std::min(best[mode], elapsed);
+            same = same && result.complete && symbols == tokens;
+        }
+    }
+    ::printf("%12s %12s %14s %12s\n", "", "time(ms)", "tokens/s", "MB/s");
+    const char *names[] = {"vectorized", "bytewise", "lex+parse"};
+    for (int mode = 0; mode < 3; mode++) {
+        ::printf("%12s %12.2f %14.0f %12.1f\n", names[mode], best[mode] * 1000, tokens.size() / best[mode],
+                 text.size() / best[mode] / 1e6);
+    }
+    ::printf("%zu bytes, %zu tokens, %zu lexer states, same tokens %s, accepted %s\n", text.size(), tokens.size(),
+             lexerTable.stateCount(), same ? "yes" : "no", accepted ? "yes" : "no");
+    return same && accepted ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include "../../src/Context.h"
+#include "../../src/LrParser.h"
+#include "../../src/TableOptimizer.h"
+#include "../../test/lua/LuaGrammar.h"
+#include "../SentenceGenerator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+// parses a synthetic lua program made of random statements and reports the throughput of LrParser, with the
+// table as generated and with the one TableOptimizer made. statements the table rejects on their own are
+// skipped, the first argument is the number of tokens.
+int main(int argc, char *argv[]) {
+    size_t target = argc > 1 ? static_cast<size_t>(::atol(argv[1])) : 1000000;
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    auto states = context.generateLr1Parallel();
+    auto table = context.table(states);
+    int eof = Item{"$", ItemType::Terminal}.getId();
+    LrParser parser{table, eof};
+
+    SentenceGenerator generator{context.getGrammar(), 42, 12};
+    vector<int> tokens{};
+    vector<int> statement{};
+    size_t kept = 0;
+    size_t skipped = 0;
+    while (tokens.size() < target) {
+        statement.clear();
+        generator.generate(lua.stat.getId(), statement);
+        // a statement starting with ( would continue the expression before it
+        if (statement.front() == lua.l_bracket.getId() || !parser.parse(statement).accepted) {
+            skipped++;
+            continue;
+        }
+        tokens.insert(tokens.end(), statement.begin(), statement.end());
+        kept++;
+    }
+
+    // the best of five parses of the whole program
+    struct Run {
+        double seconds;
+        ParseResult result;
+        size_t reductions;
+    };
+    auto measure = [&tokens, eof](const ParseTable &parsed) {
+        LrParser runner{parsed, eof};
+        size_t reductions = 0;
+        runner.onReduce([&reductions](int, size_t, size_t) { reductions++; });
+        Run run{0, ParseResult{}, 0};
+        for (int round = 0; round < 5; round++) {
+            reductions = 0;
+            auto begin = chrono::steady_clock::now();
+            run.result = runner.parse(tokens);
+            auto elapsed = chrono::duration<double>(chrono::steady_clock::now() - begin).count();
+            run.seconds = round == 0 ? elapsed : std::min(run.seconds, elapsed);
+        }
+        run.reductions = reductions;
+        return run;
+    };
+
+    // the same table with default reductions and without the unit reductions
+    auto optimized = table;
+    TableOptimizer optimizer{optimized};
+    auto defaults = optimizer.addDefaultReductions();
+    auto units = optimizer.eliminateUnitRules();
+
+    auto plain = measure(table);
+    auto fast = measure(optimized);
+    ::printf("%-10s %10s %10s %10s %12s %10s %12s %14s %12s\n", "table", "states", "statements", "skipped",
+             "tokens", "accepted", "time(ms)", "tokens/s", "reductions");
+    for (auto row : {make_pair("plain", &plain), make_pair("optimized", &fast)}) {
+        auto &run = *row.second;
+        auto stateCount = row.second == &plain ? table.stateCount() : optimized.stateCount();
+        ::printf("%-10s %10zu %10zu %10zu %12zu %10s %12.2f %14.0f %12zu\n", row.first, stateCount, kept, skipped,
+                 tokens.size(), run.result.accepted ? "yes" : "no", run.seconds * 1000, tokens.size() / run.seconds,
+                 run.reductions);
+    }
+    ::printf("default reductions %zu replacing %zu reduce entries, action entries %zu -> %zu\n",
+             defaults.defaultReductions, defaults.replacedReduces, defaults.before.actionEntries,
+             defaults.after.actionEntries);
+    ::printf("unit rules: %zu gotos bypass %zu reductions, states %zu -> %zu, bytes %zu -> %zu\n",
+             units.bypassedGotos, units.bypassedReductions, units.statesBefore, units.statesAfter,
+             units.before.actionBytes + units.before.gotoBytes, units.after.actionBytes + units.after.gotoBytes);
+    ::printf("runtime reductions saved %zu of %zu\n", plain.reductions - fast.reductions, plain.reductions);
+    return plain.result.accepted && fast.result.accepted ? 0 : 1;
+}
@@ -0,0 +1,46 @@
+#include "../../src/Context.h"
+#include "../../test/lua/LuaGrammar.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+// builds the lr(1) states of the lua grammar with the first n alternatives of `stat`,
+// the time per state should stay flat while the number of states grows.
+// the last column is generateLr1Parallel() with the thread count of the first argument, every core by default.
+int main(int argc, char *argv[]) {
+    LuaGrammar lua{};
+    int alternatives = 0;
+    for (auto &p : lua.productionList) {
+        if (p.getItem() == lua.stat) {
+            alternatives++;
+        }
+    }
+    size_t threads = argc > 1 ? static_cast<size_t>(::atoi(argv[1])) : 0;
+    ::printf("%12s %10s %12s %12s %12s %12s %14s\n", "alternatives", "states", "time(ms)", "us/state", "cache hits",
+             "cache misses", "parallel(ms)");
+    for (int n = 1; n <= alternatives; n++) {
+        vector<Production> productions{};
+        int seen = 0;
+        for (auto &p : lua.productionList) {
+            if (p.getItem() == lua.stat && seen++ >= n) {
+                continue;
+            }
+            productions.push_back(p);
+        }
+        Context context{productions, productions[0]};
+        context.first();
+        context.follow();
+        auto begin = chrono::steady_clock::now();
+        auto states = context.generalLr1();
+        auto elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+        begin = chrono::steady_clock::now();
+        context.generateLr1Parallel(threads);
+        auto parallel = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+        auto &cache = context.getClosureCache();
+        ::printf("%12d %10zu %12.2f %12.2f %12zu %12zu %14.2f\n", n, states.size(), elapsed,
+                 elapsed * 1000 / states.size(), cache.hits(), cache.misses(), parallel);
+    }
+    return 0;
+}
@@ -0,0 +1,70 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// bump allocator for objects which are released together. an allocation is a pointer increment inside the
+// current chunk, release() frees every chunk at once and nothing is freed before that.
+class Arena {
+public:
+    explicit Arena(size_t chunkSize = 64u << 10u) : chunkBytes{chunkSize} {
+    }
+
+    Arena(const Arena &) = delete;
+
+    Arena &operator=(const Arena &) = delete;
+
+    // room for count objects of T, never destroyed, so T has to be trivially destructible
+    template<typename T>
+    T *allocate(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "the arena does not run destructors");
+        auto bytes = count * sizeof(T);
+        auto offset = (alignof(T) - reinterpret_cast<size_t>(cursor) % alignof(T)) % alignof(T);
+        if (cursor == nullptr || offset + bytes > static_cast<size_t>(limit - cursor)) {
+            grow(bytes + alignof(T));
+            offset = (alignof(T) - reinterpret_cast<size_t>(cursor) % alignof(T)) % alignof(T);
+        }
+        auto result = reinterpret_cast<T *>(cursor + offset);
+        cursor += offset + bytes;
+        used += bytes;
+        return result;
+    }
+
+    void release() {
+        chunks.clear();
+        cursor = nullptr;
+        limit = nullptr;
+        used = 0;
+        reserved = 0;
+    }
+
+    // the bytes handed out and the bytes of the chunks holding them
+    size_t bytes() const {
+        return used;
+    }
+
+    size_t capacity() const {
+        return reserved;
+    }
+
+private:
+    void grow(size_t bytes) {
+        auto size = bytes > chunkBytes ? bytes : chunkBytes;
+        chunks.emplace_back(new char[size]);
+        cursor = chunks.back().get();
+        limit = cursor + size;
+        reserved += size;
+    }
+
+    size_t chunkBytes;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char *cursor = nullptr;
+    char *limit = nullptr;
+    size_t used = 0;
+    size_t reserved = 0;
+};
+
+#endif
@@ -0,0 +1,202 @@
+#ifndef BIT_SET_H
+#define BIT_SET_H
+
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+// dense set over the terminal indexes of a grammar. sets of up to 128 bits keep their words inline, so
+// copying the look forward of an item allocates nothing for most grammars.
+class BitSet {
+public:
+    BitSet() = default;
+
+    explicit BitSet(size_t size) {
+        resize(size);
+    }
+
+    BitSet(const BitSet &other) {
+        *this = other;
+    }
+
+    BitSet(BitSet &&other) noexcept {
+        *this = std::move(other);
+    }
+
+    BitSet &operator=(const BitSet &other) {
+        if (this != &other) {
+            reserve(other.wordCount);
+            bitCount = other.bitCount;
+            wordCount = other.wordCount;
+            std::copy(other.words, other.words + wordCount, words);
+        }
+        return *this;
+    }
+
+    BitSet &operator=(BitSet &&other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+        if (other.heap) {
+            heap = std::move(other.heap);
+            heapWords = other.heapWords;
+            words = heap.get();
+        } else {
+            reserve(other.wordCount);
+            std::copy(other.words, other.words + other.wordCount, words);
+        }
+        bitCount = other.bitCount;
+        wordCount = other.wordCount;
+        other.words = other.local;
+        other.heapWords = 0;
+        other.bitCount = 0;
+        other.wordCount = 0;
+        return *this;
+    }
+
+    size_t size() const {
+        return bitCount;
+    }
+
+    void resize(size_t size) {
+        auto count = (size + 63) / 64;
+        reserve(count);
+        for (auto i = wordCount; i < count; i++) {
+            words[i] = 0;
+        }
+        bitCount = size;
+        wordCount = count;
+    }
+
+    bool test(size_t index) const {
+        return (words[index >> 6] >> (index & 63)) & 1u;
+    }
+
+    // returns true if the bit was not set before
+    bool set(size_t index) {
+        auto &word = words[index >> 6];
+        auto mask = uint64_t{1} << (index & 63);
+        bool changed = (word & mask) == 0;
+        word |= mask;
+        return changed;
+    }
+
+    void reset(size_t index) {
+        words[index >> 6] &= ~(uint64_t{1} << (index & 63));
+    }
+
+    void clear() {
+        std::fill(words, words + wordCount, 0);
+    }
+
+    // returns true if any new bit was added
+    bool unionWith(const BitSet &other) {
+        uint64_t added = 0;
+        for (size_t i = 0; i < wordCount; i++) {
+            auto merged = words[i] | other.words[i];
+            added |= merged ^ words[i];
+            words[i] = merged;
+        }
+        return added != 0;
+    }
+
+    bool contains(const BitSet &other) const {
+        for (size_t i = 0; i < wordCount; i++) {
+            if ((other.words[i] & ~words[i]) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool intersects(const BitSet &other) const {
+        for (size_t i = 0; i < wordCount; i++) {
+            if ((other.words[i] & words[i]) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool empty() const {
+        for (size_t i = 0; i < wordCount; i++) {
+            if (words[i] != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t count() const {
+        size_t result = 0;
+        for (size_t i = 0; i < wordCount; i++) {
+            result += __builtin_popcountll(words[i]);
+        }
+        return result;
+    }
+
+    template<typename Function>
+    void forEach(Function function) const {
+        for (size_t i = 0; i < wordCount; i++) {
+            auto word = words[i];
+            while (word != 0) {
+                function(i * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+    }
+
+    size_t hash() const {
+        uint64_t result = 1469598103934665603ull;
+        for (size_t i = 0; i < wordCount; i++) {
+            result = (result ^ words[i]) * 1099511628211ull;
+        }
+        return static_cast<size_t>(result ^ (result >> 32));
+    }
+
+    const uint64_t *data() const {
+        return words;
+    }
+
+    size_t wordSize() const {
+        return wordCount;
+    }
+
+    bool operator==(const BitSet &other) const {
+        return bitCount == other.bitCount && std::equal(words, words + wordCount, other.words);
+    }
+
+    bool operator!=(const BitSet &other) const {
+        return !(*this == other);
+    }
+
+    bool operator<(const BitSet &other) const {
+        return std::lexicographical_compare(words, words + wordCount, other.words, other.words + other.wordCount);
+    }
+
+private:
+    static constexpr size_t localWords = 2;
+
+    // room for count words, keeps the words already there
+    void reserve(size_t count) {
+        if (count <= localWords || count <= heapWords) {
+            return;
+        }
+        std::unique_ptr<uint64_t[]> grown{new uint64_t[count]};
+        std::copy(words, words + wordCount, grown.get());
+        heap = std::move(grown);
+        heapWords = count;
+        words = heap.get();
+    }
+
+    size_t bitCount = 0;
+    size_t wordCount = 0;
+    uint64_t local[localWords] = {0, 0};
+    uint64_t *words = local;
+    std::unique_ptr<uint64_t[]> heap;
+    size_t heapWords = 0;
+};
+
+#endif
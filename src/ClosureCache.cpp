@@ -0,0 +1,97 @@
+#include "ClosureCache.h"
+#include <algorithm>
+
+using std::vector;
+using std::make_shared;
+using std::move;
+
+ClosureCache::ClosureCache(size_t byteLimit) : limit{byteLimit}, entries{}, recency{}, key{}, order{} {
+
+}
+
+size_t ClosureCache::KeyHash::operator()(const Key &key) const {
+    uint64_t result = 1469598103934665603ull;
+    for (auto word : key) {
+        result = (result ^ word) * 1099511628211ull;
+    }
+    return static_cast<size_t>(result ^ (result >> 29));
+}
+
+void ClosureCache::makeKey(const vector<LrItem> &kernel) {
+    order.resize(kernel.size());
+    for (int i = 0; i < static_cast<int>(kernel.size()); i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&kernel](int a1, int a2) {
+        if (kernel[a1].production != kernel[a2].production) {
+            return kernel[a1].production < kernel[a2].production;
+        }
+        return kernel[a1].position < kernel[a2].position;
+    });
+    key.clear();
+    for (auto i : order) {
+        auto &item = kernel[i];
+        key.push_back(static_cast<uint64_t>(item.production) << 32u | static_cast<uint32_t>(item.position));
+        auto words = item.lookForward.data();
+        key.insert(key.end(), words, words + item.lookForward.wordSize());
+    }
+}
+
+ClosureCache::Result ClosureCache::find(const vector<LrItem> &kernel) {
+    if (limit == 0) {
+        missCount++;
+        return nullptr;
+    }
+    makeKey(kernel);
+    auto ptr = entries.find(key);
+    if (ptr == entries.end()) {
+        missCount++;
+        return nullptr;
+    }
+    hitCount++;
+    recency.splice(recency.begin(), recency, ptr->second.recent);
+    return ptr->second.closure;
+}
+
+ClosureCache::Result ClosureCache::insert(const vector<LrItem> &kernel, vector<LrItem> closure) {
+    size_t bytes = sizeof(Entry) + closure.size() * sizeof(LrItem);
+    for (auto &item : closure) {
+        bytes += item.lookForward.wordSize() * sizeof(uint64_t);
+    }
+    Result result = make_shared<const vector<LrItem>>(move(closure));
+    if (limit == 0) {
+        return result;
+    }
+    makeKey(kernel);
+    bytes += key.size() * sizeof(uint64_t);
+    auto inserted = entries.emplace(key, Entry{result, bytes, recency.end()});
+    if (!inserted.second) {
+        return inserted.first->second.closure;
+    }
+    recency.push_front(&inserted.first->first);
+    inserted.first->second.recent = recency.begin();
+    used += bytes;
+    shrink();
+    return result;
+}
+
+void ClosureCache::setByteLimit(size_t byteLimit) {
+    limit = byteLimit;
+    shrink();
+}
+
+void ClosureCache::clear() {
+    entries.clear();
+    recency.clear();
+    used = 0;
+}
+
+void ClosureCache::shrink() {
+    while (used > limit && !recency.empty()) {
+        auto ptr = entries.find(*recency.back());
+        used -= ptr->second.bytes;
+        recency.pop_back();
+        entries.erase(ptr);
+        evictionCount++;
+    }
+}
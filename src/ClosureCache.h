@@ -0,0 +1,89 @@
+#ifndef CLOSURE_CACHE_H
+#define CLOSURE_CACHE_H
+
+#include "LrItem.h"
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// memoizes the closure of a kernel. the key is the kernel sorted by (production, position) with its
+// look forward sets, so the same kernel generated in another order hits the same entry.
+// the least recently used entries are dropped once the cache holds more than byteLimit bytes.
+class ClosureCache {
+public:
+    using Result = std::shared_ptr<const std::vector<LrItem>>;
+
+    explicit ClosureCache(size_t byteLimit = 64u << 20u);
+
+    // the recency list points at the keys of the map, a move keeps their nodes but a copy would not
+    ClosureCache(const ClosureCache &) = delete;
+
+    ClosureCache &operator=(const ClosureCache &) = delete;
+
+    ClosureCache(ClosureCache &&) = default;
+
+    ClosureCache &operator=(ClosureCache &&) = default;
+
+    // returns the cached closure of kernel, or nullptr
+    Result find(const std::vector<LrItem> &kernel);
+
+    Result insert(const std::vector<LrItem> &kernel, std::vector<LrItem> closure);
+
+    void setByteLimit(size_t limit);
+
+    void clear();
+
+    size_t byteLimit() const {
+        return limit;
+    }
+
+    size_t bytes() const {
+        return used;
+    }
+
+    size_t size() const {
+        return entries.size();
+    }
+
+    size_t hits() const {
+        return hitCount;
+    }
+
+    size_t misses() const {
+        return missCount;
+    }
+
+    size_t evictions() const {
+        return evictionCount;
+    }
+
+private:
+    using Key = std::vector<uint64_t>;
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+
+    struct Entry {
+        Result closure;
+        size_t bytes;
+        std::list<const Key *>::iterator recent;
+    };
+
+    void makeKey(const std::vector<LrItem> &kernel);
+
+    void shrink();
+
+    size_t limit;
+    size_t used = 0;
+    size_t hitCount = 0;
+    size_t missCount = 0;
+    size_t evictionCount = 0;
+    std::unordered_map<Key, Entry, KeyHash> entries;
+    std::list<const Key *> recency;
+    Key key;
+    std::vector<int> order;
+};
+
+#endif
@@ -0,0 +1,182 @@
+#include "ClosureEngine.h"
+#include <deque>
+#include <algorithm>
+
+using std::vector;
+using std::deque;
+
+void ClosureEngine::prepare(const Grammar &grammarRef, const FirstFollow &setsRef) {
+    grammar = &grammarRef;
+    sets = &setsRef;
+    auto width = sets->terminalCount();
+    auto &noTerminals = grammar->noTerminals();
+    auto count = noTerminals.size();
+    noTerminalSymbol = noTerminals;
+    leading.assign(count, vector<int>{});
+    for (size_t n = 0; n < count; n++) {
+        for (auto p : grammar->productionsOf(noTerminals[n])) {
+            auto &rhs = grammar->rhs(p);
+            if (rhs.empty()) {
+                continue;
+            }
+            int next = grammar->noTerminalIndex(rhs.front());
+            if (next != -1 && std::find(leading[n].begin(), leading[n].end(), next) == leading[n].end()) {
+                leading[n].push_back(next);
+            }
+        }
+    }
+
+    // solve the look forward of every no terminal reachable from n, relative to the look forward
+    // of the item which expands n
+    reachList.assign(count, vector<Reach>{});
+    vector<int> position(count, -1);
+    for (size_t n = 0; n < count; n++) {
+        auto &reach = reachList[n];
+        deque<int> work{};
+        reach.push_back(Reach{static_cast<int>(n), BitSet{width}, true});
+        position[n] = 0;
+        work.push_back(static_cast<int>(n));
+        while (!work.empty()) {
+            int current = work.front();
+            work.pop_front();
+            counters.iterations++;
+            for (auto p : grammar->productionsOf(noTerminals[current])) {
+                auto &rhs = grammar->rhs(p);
+                if (rhs.empty()) {
+                    continue;
+                }
+                int next = grammar->noTerminalIndex(rhs.front());
+                if (next == -1) {
+                    continue;
+                }
+                BitSet look{width};
+                bool tailNullable = sets->firstOf(rhs.data() + 1, rhs.data() + rhs.size(), look);
+                bool discovered = position[next] == -1;
+                if (discovered) {
+                    position[next] = static_cast<int>(reach.size());
+                    reach.push_back(Reach{next, BitSet{width}, false});
+                }
+                auto &from = reach[position[current]];
+                auto &to = reach[position[next]];
+                bool changed = to.lookForward.unionWith(look);
+                if (tailNullable) {
+                    changed = to.lookForward.unionWith(from.lookForward) || changed;
+                    if (from.inherit && !to.inherit) {
+                        to.inherit = true;
+                        changed = true;
+                    }
+                }
+                if (discovered || changed) {
+                    work.push_back(next);
+                }
+            }
+        }
+        for (auto &r : reach) {
+            position[r.noTerminal] = -1;
+        }
+    }
+
+    slotStamp.assign(grammar->itemBound(), 0);
+    slot.assign(grammar->itemBound(), 0);
+    reachStamp.assign(count, 0);
+    queueStamp.assign(count, 0);
+    reachLook.assign(count, BitSet{width});
+    incoming = BitSet{width};
+    stamp = 0;
+}
+
+void ClosureEngine::rebind(const Grammar &grammarRef, const FirstFollow &setsRef) {
+    if (prepared()) {
+        grammar = &grammarRef;
+        sets = &setsRef;
+    }
+}
+
+void ClosureEngine::close(vector<LrItem> &items) {
+    counters.closes++;
+    stamp++;
+    kernel.clear();
+    for (auto &item : items) {
+        auto id = grammar->itemId(item.production, item.position);
+        if (slotStamp[id] == stamp) {
+            counters.merges += kernel[slot[id]].lookForward.unionWith(item.lookForward);
+            continue;
+        }
+        slotStamp[id] = stamp;
+        slot[id] = static_cast<int>(kernel.size());
+        kernel.push_back(std::move(item));
+    }
+
+    // the look forward every reachable no terminal receives from all kernel items
+    for (auto &item : kernel) {
+        int n = nextNoTerminal(item);
+        if (n == -1) {
+            continue;
+        }
+        auto &rhs = grammar->rhs(item.production);
+        incoming.clear();
+        if (sets->firstOf(rhs.data() + item.position + 1, rhs.data() + rhs.size(), incoming)) {
+            incoming.unionWith(item.lookForward);
+        }
+        for (auto &r : reachList[n]) {
+            if (reachStamp[r.noTerminal] != stamp) {
+                reachStamp[r.noTerminal] = stamp;
+                reachLook[r.noTerminal].clear();
+            }
+            bool merged = reachLook[r.noTerminal].unionWith(r.lookForward);
+            if (r.inherit) {
+                merged = reachLook[r.noTerminal].unionWith(incoming) || merged;
+            }
+            counters.merges += merged;
+        }
+    }
+
+    // every kernel item is followed by the closure items it introduces first, breadth first
+    items.clear();
+    stamp++;
+    for (auto &item : kernel) {
+        auto id = grammar->itemId(item.production, item.position);
+        if (slotStamp[id] == stamp) {
+            counters.merges += items[slot[id]].lookForward.unionWith(item.lookForward);
+            continue;
+        }
+        slotStamp[id] = stamp;
+        slot[id] = static_cast<int>(items.size());
+        int n = nextNoTerminal(item);
+        items.push_back(std::move(item));
+        if (n == -1 || queueStamp[n] == stamp) {
+            continue;
+        }
+        queueStamp[n] = stamp;
+        queue.clear();
+        queue.push_back(n);
+        for (size_t head = 0; head < queue.size(); head++) {
+            int current = queue[head];
+            counters.iterations++;
+            for (auto p : grammar->productionsOf(noTerminalSymbol[current])) {
+                auto closureId = grammar->itemId(p, 0);
+                if (slotStamp[closureId] == stamp) {
+                    counters.merges += items[slot[closureId]].lookForward.unionWith(reachLook[current]);
+                    continue;
+                }
+                slotStamp[closureId] = stamp;
+                slot[closureId] = static_cast<int>(items.size());
+                items.push_back(LrItem{p, 0, reachLook[current]});
+            }
+            for (auto next : leading[current]) {
+                if (queueStamp[next] != stamp) {
+                    queueStamp[next] = stamp;
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+}
+
+int ClosureEngine::nextNoTerminal(const LrItem &item) const {
+    auto &rhs = grammar->rhs(item.production);
+    if (item.position >= static_cast<int>(rhs.size())) {
+        return -1;
+    }
+    return grammar->noTerminalIndex(rhs[item.position]);
+}
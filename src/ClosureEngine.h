@@ -0,0 +1,69 @@
+#ifndef CLOSURE_ENGINE_H
+#define CLOSURE_ENGINE_H
+
+#include "Grammar.h"
+#include "FirstFollow.h"
+#include "LrItem.h"
+
+// lr(1) closure over LrItems.
+// for every no terminal B the lr(0) closure is computed once together with the look forward each
+// reachable no terminal C receives: the terminals it always gets and whether the look forward of
+// the item expanding B flows into it. closing a state is then a single pass without a fixpoint.
+class ClosureEngine {
+public:
+    // the work done since the last takeCounters()
+    struct Counters {
+        size_t closes = 0;
+        // steps of the prepare() fixpoint and no terminals expanded by close()
+        size_t iterations = 0;
+        // look forward sets which grew by a merge, of a reached no terminal or of an item already in the closure
+        size_t merges = 0;
+    };
+
+    void prepare(const Grammar &grammar, const FirstFollow &sets);
+
+    // points a prepared engine at the grammar and sets of a moved context, the tables do not depend on their address
+    void rebind(const Grammar &grammar, const FirstFollow &sets);
+
+    // closes the kernel in place, every kernel item is followed by the closure items it adds
+    void close(std::vector<LrItem> &items);
+
+    bool prepared() const {
+        return grammar != nullptr;
+    }
+
+    Counters takeCounters() {
+        Counters result{counters};
+        counters = Counters{};
+        return result;
+    }
+
+private:
+    struct Reach {
+        int noTerminal;
+        BitSet lookForward;
+        bool inherit;
+    };
+
+    int nextNoTerminal(const LrItem &item) const;
+
+    const Grammar *grammar = nullptr;
+    const FirstFollow *sets = nullptr;
+    std::vector<int> noTerminalSymbol;
+    std::vector<std::vector<Reach>> reachList;
+    std::vector<std::vector<int>> leading;
+
+    // scratch state of close(), reset by bumping the stamp
+    int stamp = 0;
+    std::vector<int> slotStamp;
+    std::vector<int> slot;
+    std::vector<int> reachStamp;
+    std::vector<int> queueStamp;
+    std::vector<BitSet> reachLook;
+    std::vector<int> queue;
+    std::vector<LrItem> kernel;
+    BitSet incoming;
+    Counters counters;
+};
+
+#endif
@@ -1,9 +1,13 @@
 #include "Context.h"
+#include "Lalr.h"
+#include "MinimalLr.h"
+#include "ParallelLr.h"
 #include <algorithm>
 #include <iostream>
 #include <utility>
 #include <cstdio>
 #include <cstring>
+#include <tuple>
 
 extern const Item EMPTY{"000", ItemType::Terminal};
 extern const Item Eof{"$", ItemType::Terminal};
@@ -19,127 +23,162 @@ using std::back_inserter;
 using std::begin;
 using std::end;
 using std::runtime_error;
-using std::array;
 
-Context::Context(vector<Production> grammar, Production startProduction) : ruleList(move(grammar)), firstSet{},
-                                                                           followSet{},
-                                                                           start(move(startProduction)) {
+Context::Context(vector<Production> rules, Production startProduction) : start(move(startProduction)),
+                                                                         ruleList(move(rules)),
+                                                                         grammar{ruleList, start},
+                                                                         firstFollow{},
+                                                                         closure{},
+                                                                         closureCache{},
+                                                                         firstSet{},
+                                                                         followSet{},
+                                                                         precedence{},
+                                                                         conflictList{},
+                                                                         statistics{},
+                                                                         pool{InternPool::acquire()},
+                                                                         sharedRules{},
+                                                                         sharedIndex{},
+                                                                         lookScratch{},
+                                                                         gotoSymbols{},
+                                                                         gotoKernel{} {
+    sharedRules.reserve(ruleList.size());
+    for (size_t i = 0; i < ruleList.size(); i++) {
+        auto shared = &pool->productions().intern(ruleList[i]);
+        sharedRules.push_back(shared);
+        sharedIndex.emplace(shared, static_cast<int>(i));
+    }
+}
 
+Context::Context(Context &&other) noexcept : start(move(other.start)),
+                                             ruleList(move(other.ruleList)),
+                                             grammar(move(other.grammar)),
+                                             firstFollow(move(other.firstFollow)),
+                                             closure(move(other.closure)),
+                                             closureCache(move(other.closureCache)),
+                                             firstSet(move(other.firstSet)),
+                                             followSet(move(other.followSet)),
+                                             precedence(move(other.precedence)),
+                                             conflictList(move(other.conflictList)),
+                                             resolvedConflicts(other.resolvedConflicts),
+                                             statistics(move(other.statistics)),
+                                             pool(move(other.pool)),
+                                             sharedRules(move(other.sharedRules)),
+                                             sharedIndex(move(other.sharedIndex)),
+                                             lookScratch(move(other.lookScratch)),
+                                             gotoSymbols(move(other.gotoSymbols)),
+                                             gotoKernel(move(other.gotoKernel)) {
+    closure.rebind(grammar, firstFollow);
+}
+
+Context &Context::operator=(Context &&other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    start = move(other.start);
+    ruleList = move(other.ruleList);
+    grammar = move(other.grammar);
+    firstFollow = move(other.firstFollow);
+    closure = move(other.closure);
+    closureCache = move(other.closureCache);
+    firstSet = move(other.firstSet);
+    followSet = move(other.followSet);
+    precedence = move(other.precedence);
+    conflictList = move(other.conflictList);
+    resolvedConflicts = other.resolvedConflicts;
+    statistics = move(other.statistics);
+    pool = move(other.pool);
+    sharedRules = move(other.sharedRules);
+    sharedIndex = move(other.sharedIndex);
+    lookScratch = move(other.lookScratch);
+    gotoSymbols = move(other.gotoSymbols);
+    gotoKernel = move(other.gotoKernel);
+    closure.rebind(grammar, firstFollow);
+    return *this;
 }
 
 void Context::first() {
-    bool hasChanged;
-    for (auto &p : ruleList) {
-        if (firstSet.find(p.getName()) == end(firstSet)) {
-            firstSet.insert(pair<string, set<Item>>{p.getName(), set<Item>{}});
+    auto phase = statistics.phase("first");
+    firstFollow.computeFirst(grammar);
+    firstSet.clear();
+    auto materialize = [this](const Item &item) {
+        if (firstSet.find(item.getId()) != end(firstSet)) {
+            return;
+        }
+        auto &result = firstSet[item.getId()];
+        if (item == EMPTY) {
+            result.insert(EMPTY);
+            return;
+        }
+        firstFollow.first(item.getId()).forEach([this, &result](size_t index) {
+            result.emplace(grammar.terminals()[index]);
+        });
+        if (firstFollow.nullable(item.getId())) {
+            result.insert(EMPTY);
         }
+    };
+    for (auto &p : ruleList) {
+        materialize(p.getItem());
         for (auto &i : p) {
-            bool exists = firstSet.find(i.getName()) != end(firstSet);
-            if (!exists && i.isNoTerminal()) {
-                firstSet.insert(pair<string, set<Item>>{i.getName(), set<Item>{}});
-            } else if (!exists && i.isTerminal()) {
-                firstSet.insert(pair<string, set<Item>>{i.getName(), set<Item>{i}});
-            }
+            materialize(i);
         }
     }
-    do {
-        hasChanged = false;
-        for (auto &p : ruleList) {
-            set<Item> rhs{};
-            if (p.size() < 1) {
-                continue;
-            }
-            auto first = firstAt(p.first())->second;
-            rhs.insert(begin(first), end(first));
-            rhs.erase(EMPTY);
-            int k = 0;
-            if (p.size() > 1) {
-                while (k < p.size() - 1 && isNullable(p[k])) {
-                    auto nextFirst = firstAt(p[k + 1])->second;
-                    rhs.insert(begin(nextFirst), end(nextFirst));
-                    rhs.erase(EMPTY);
-                    k++;
-                }
-                if (k == p.size() - 1 && isNullable(p[k])) {
-                    rhs.insert(EMPTY);
-                }
-            } else if (p.first().isTerminal()) {
-                rhs.emplace(p.first());
-            }
-            for (auto &i : rhs) {
-                auto pa = p.getName();
-                if (firstAt(pa) == end(firstSet)) {
-                    throw runtime_error("invalid first element.");
-                }
-                auto &first2p = firstAt(pa)->second;
-                if (first2p.find(i) == end(first2p)) {
-                    hasChanged = true;
-                    first2p.emplace(i);
-                }
-            }
-        }
-    } while (hasChanged);
+}
+
+void Context::prepareClosure() {
+    if (closure.prepared()) {
+        return;
+    }
+    if (firstSet.empty()) {
+        first();
+    }
+    auto phase = statistics.phase("closure");
+    closure.prepare(grammar, firstFollow);
+    closureCache.clear();
+    collectClosureCounters(closure.takeCounters());
 }
 
 void Context::follow() {
-    const auto startItem = start.getItem();
-    followSet.emplace(pair<string, set<Item>>(startItem.getName(), set<Item>{Eof}));
-
-    bool hasChanged;
-    do {
-        hasChanged = false;
-        for (auto &p : ruleList) {
-            set<Item> result{};
-            if (followSet.find(p.getName()) != followSet.end()) {
-                result = followSet.find(p.getName())->second;
-            }
-            for (int j = p.size() - 1; j >= 0; j--) {
-                auto &item = p[j];
-                if (item.isNoTerminal()) {
-                    if (followSet.find(item.getName()) == followSet.end()) {
-                        followSet.insert(pair<string, set<Item>>(item.getName(), result));
-                    } else {
-                        auto &follow = followSet.find(item.getName())->second;
-                        for (auto &i : result) {
-                            if (follow.find(i) == follow.end()) {
-                                hasChanged = true;
-                                follow.emplace(i);
-                            }
-                        }
-                    }
-                    if (firstSet.find(item.getName()) == end(firstSet)) {
-                        throw runtime_error("invalid item for first table");
-                    }
-                    auto &firstTable = firstSet.find(item.getName())->second;
-                    if (firstTable.find(EMPTY) != firstTable.end()) {
-                        result.insert(firstTable.begin(), firstTable.end());
-                        result.erase(EMPTY);
-                    } else {
-                        result = firstTable;
-                    }
-                } else {
-                    if (item == EMPTY) {
-                        continue;
-                    }
-                    result = set<Item>{item};
-                }
+    auto phase = statistics.phase("follow");
+    if (firstSet.empty()) {
+        first();
+    }
+    firstFollow.computeFollow(grammar);
+    followSet.clear();
+    auto materialize = [this](const Item &item) {
+        if (followSet.find(item.getId()) != followSet.end()) {
+            return;
+        }
+        auto &result = followSet[item.getId()];
+        firstFollow.follow(item.getId()).forEach([this, &result](size_t index) {
+            result.emplace(grammar.terminals()[index]);
+        });
+    };
+    materialize(start.getItem());
+    for (auto &p : ruleList) {
+        for (auto &i : p) {
+            if (i.isNoTerminal()) {
+                materialize(i);
             }
         }
-    } while (hasChanged);
+    }
 }
 
 bool Context::isNullable(const Item &item) {
-    auto iterator = firstSet.find(item.getName());
-    if (iterator == end(firstSet)) {
-        return false;
-    } else {
-        return iterator->second.find(EMPTY) != iterator->second.end();
-    }
+    return firstFollow.nullable(item.getId());
 }
 
-void Context::printFirst() {
-    for (auto &pair : firstSet) {
-        cout << pair.first << " -> {";
+// the sets are keyed by symbol id, sort them by name again so the output stays readable.
+static void printSymbolSet(const std::map<int, set<Item>> &symbolSet) {
+    auto byName = [](const Item &a1, const Item &a2) { return a1.getName() < a2.getName(); };
+    vector<pair<Item, vector<Item>>> sorted{};
+    for (auto &pair : symbolSet) {
+        vector<Item> items{pair.second.begin(), pair.second.end()};
+        std::sort(items.begin(), items.end(), byName);
+        sorted.emplace_back(Item{pair.first}, move(items));
+    }
+    std::sort(sorted.begin(), sorted.end(), [&byName](auto &a1, auto &a2) { return byName(a1.first, a2.first); });
+    for (auto &pair : sorted) {
+        cout << pair.first.getName() << " -> {";
         for (auto p = pair.second.begin(), n = pair.second.end(); p != pair.second.end(); p++) {
             cout << '\'' << p->getName() << '\'';
             n = p;
@@ -153,6 +192,10 @@ void Context::printFirst() {
     }
 }
 
+void Context::printFirst() {
+    printSymbolSet(firstSet);
+}
+
 void Context::printGrammar() {
     for (auto p : ruleList) {
         cout << p.getItem().getName() << " -> ";
@@ -164,27 +207,15 @@ void Context::printGrammar() {
 }
 
 void Context::printFollow() {
-    for (auto &pair : followSet) {
-        cout << pair.first << " -> {";
-        for (auto p = pair.second.begin(), n = pair.second.end(); p != pair.second.end(); p++) {
-            cout << '\'' << p->getName() << '\'';
-            n = p;
-            n++;
-            if (n != pair.second.end()) {
-                cout << " ,";
-            } else {
-                cout << "}" << endl;
-            }
-        }
-    }
+    printSymbolSet(followSet);
 }
 
 auto Context::firstAt(const Item &item) -> decltype(firstSet.begin()) {
-    return firstSet.find(item.getName());
+    return firstSet.find(item.getId());
 }
 
 auto Context::firstAt(const string &name) -> decltype(firstSet.begin()) {
-    return firstSet.find(name);
+    return firstSet.find(symbolOf(name));
 }
 
 bool Context::firstExist(const Item &item) {
@@ -196,15 +227,23 @@ bool Context::firstExist(const std::string &name) {
 }
 
 auto Context::followAt(const Item &item) -> decltype(followSet.begin()) {
-    return followSet.find(item.getName());
+    return followSet.find(item.getId());
 }
 
 auto Context::followAt(const string &name) -> decltype(followSet.begin()) {
-    return followSet.find(name);
+    return followSet.find(symbolOf(name));
+}
+
+int Context::symbolOf(const string &name) {
+    int id = SymbolTable::global().find(name, ItemType::NoTerminal);
+    if (id == -1 || grammar.noTerminalIndex(id) == -1) {
+        id = SymbolTable::global().find(name, ItemType::Terminal);
+    }
+    return id;
 }
 
 vector<HandlerSet> Context::generalLr1() {
-    bool hasChanged;
+    auto phase = statistics.phase("lr1");
     vector<HandlerSet> stateSet{};
     auto startHandler = Handler{start, 0, set<Item>{Eof}};
     vector<Handler> startHandlerVec{};
@@ -213,340 +252,451 @@ vector<HandlerSet> Context::generalLr1() {
     HandlerSet firstHandler{Eof, startHandlerVec};
     firstHandler.setId(0);
     stateSet.emplace_back(firstHandler);
-    do {
-        try {
-
-            hasChanged = false;
-            for (auto p : stateSet) {
-                auto nextStat = Goto(p);
-                for (auto stat : nextStat) {
-                    auto possPtr = std::find(stateSet.begin(), stateSet.end(), stat);
-                    if (possPtr == stateSet.end()) {
-                        hasChanged = true;
-                        stat.setId(stateSet.size());
-                        stat.setParentId(p.getId());
-                        stateSet.emplace_back(stat);
-                    }
-                }
+    StateIndex stateIndex{stateSet};
+    // the states behind `frontier` are not expanded yet, every state is expanded exactly once
+    for (size_t frontier = 0; frontier < stateSet.size(); frontier++) {
+        auto nextStat = Goto(stateSet[frontier]);
+        stateSet[frontier].reserveTransitions(nextStat.size());
+        for (auto &stat : nextStat) {
+            int id = stateIndex.find(stat);
+            auto symbol = stat.shiftItem();
+            if (id == -1) {
+                id = static_cast<int>(stateSet.size());
+                stat.setId(id);
+                stat.setParentId(static_cast<int>(frontier));
+                stateSet.push_back(move(stat));
+                stateIndex.insert(stateSet.back(), id);
             }
-        } catch (const std::exception &e) {
-            cout << "exception";
+            stateSet[frontier].addTransition(symbol, id);
         }
-    } while (hasChanged);
+    }
+    statistics.counters().dedupProbes += stateIndex.probes();
+    collectClosureCounters(closure.takeCounters());
     return stateSet;
 }
 
-vector<HandlerSet> Context::Goto(HandlerSet currState) {
-    vector<HandlerSet> result{};
-    set<Item> nTList{};
-    set<Item> tList{};
-    for (auto h : currState.ruleList()) {
-        if (h.isEnd()) {
-            continue;
+vector<HandlerSet> Context::generateLr1Parallel(size_t threads) {
+    auto phase = statistics.phase("lr1 parallel");
+    prepareClosure();
+    ThreadPool workers{threads};
+    ParallelLrBuilder builder{grammar, closure, workers};
+    auto states = builder.build();
+    statistics.counters().gotoCalls += states.size();
+    statistics.counters().dedupProbes += builder.probes();
+    collectClosureCounters(builder.takeClosureCounters());
+    return toHandlerSets(states);
+}
+
+vector<HandlerSet> Context::generateLalr1() {
+    auto phase = statistics.phase("lalr1");
+    prepareClosure();
+    LalrBuilder builder{grammar, firstFollow, closure};
+    auto states = builder.build();
+    collectClosureCounters(closure.takeCounters());
+    return toHandlerSets(states);
+}
+
+vector<HandlerSet> Context::generateMinimalLr1() {
+    auto phase = statistics.phase("minimal lr1");
+    prepareClosure();
+    MinimalLrBuilder builder{grammar, firstFollow, closure};
+    auto states = builder.build();
+    collectClosureCounters(closure.takeCounters());
+    return toHandlerSets(states);
+}
+
+vector<HandlerSet> Context::toHandlerSets(vector<LrState> &states) {
+    vector<HandlerSet> stateSet{};
+    stateSet.reserve(states.size());
+    for (size_t i = 0; i < states.size(); i++) {
+        vector<Handler> handlers{};
+        handlers.reserve(states[i].items.size());
+        for (auto &item : states[i].items) {
+            handlers.push_back(toHandler(item));
         }
-        auto item = h.current();
-        if (item.isNoTerminal()) {
-            nTList.emplace(item);
-        } else if (item.isTerminal() && item.getName() != EMPTY.getName()) {
-            tList.emplace(item);
+        stateSet.emplace_back(Item{states[i].symbol}, move(handlers));
+        auto &state = stateSet.back();
+        state.setId(static_cast<int>(i));
+        state.setParentId(states[i].parent);
+        for (auto &next : states[i].transitions) {
+            state.addTransition(Item{next.first}, next.second);
         }
     }
+    return stateSet;
+}
 
-    for (auto &nT : nTList) {
-        vector<Handler> next{};
-        for (auto h:currState.ruleList()) {
-            if (!h.isEnd() && h.current() == nT) {
-                next.emplace_back(move(h.nextHandler()));
+vector<Conflict> Context::lalrConflicts(vector<HandlerSet> &lalrStates) {
+    auto phase = statistics.phase("lalr conflicts");
+    // the productions reduced on every terminal, sorted and without duplicates
+    auto reduceSet = [this](HandlerSet &state) {
+        std::map<int, vector<int>> reduces{};
+        for (auto &handler : state.ruleList()) {
+            int production = reduceProduction(handler);
+            if (production == -1) {
+                continue;
             }
+            for (auto &look : handler.getLookForward()) {
+                reduces[look.getId()].push_back(production);
+            }
+        }
+        for (auto &pair : reduces) {
+            std::sort(pair.second.begin(), pair.second.end());
+            pair.second.erase(std::unique(pair.second.begin(), pair.second.end()), pair.second.end());
+        }
+        return reduces;
+    };
+    std::map<vector<int>, int> coreIndex{};
+    for (size_t i = 0; i < lalrStates.size(); i++) {
+        coreIndex.emplace(kernelCore(lalrStates[i]), static_cast<int>(i));
+    }
+    // (lalr state, terminal, production, production) of every conflict canonical lr(1) already has
+    set<std::tuple<int, int, int, int>> canonical{};
+    auto lr1States = generalLr1();
+    for (auto &state : lr1States) {
+        auto found = coreIndex.find(kernelCore(state));
+        if (found == coreIndex.end()) {
+            throw runtime_error("lr(1) state without lalr(1) core");
         }
-        next = closureItemSet(next);
-        result.emplace_back(HandlerSet{nT, next});
-    }
-    for (auto &t : tList) {
-        vector<Handler> next{};
-        for (auto h:currState.ruleList()) {
-            if (!h.isEnd() && h.current() == t) {
-                next.emplace_back(move(h.nextHandler()));
+        for (auto &pair : reduceSet(state)) {
+            auto &productions = pair.second;
+            for (size_t a = 0; a < productions.size(); a++) {
+                for (size_t b = a + 1; b < productions.size(); b++) {
+                    canonical.emplace(found->second, pair.first, productions[a], productions[b]);
+                }
+            }
+        }
+    }
+    vector<Conflict> result{};
+    for (size_t i = 0; i < lalrStates.size(); i++) {
+        for (auto &pair : reduceSet(lalrStates[i])) {
+            auto &productions = pair.second;
+            for (size_t a = 0; a < productions.size(); a++) {
+                for (size_t b = a + 1; b < productions.size(); b++) {
+                    if (canonical.count(std::make_tuple(static_cast<int>(i), pair.first, productions[a],
+                                                        productions[b])) == 0) {
+                        result.push_back(Conflict{static_cast<int>(i), pair.first,
+                                                  ParseAction{ActionType::Reduce, productions[a]},
+                                                  ParseAction{ActionType::Reduce, productions[b]}});
+                    }
+                }
             }
         }
-        next = closureItemSet(next);
-        result.emplace_back(t, next);
     }
     return result;
 }
 
-vector<Handler> Context::closureItemSet(vector<Handler> &handlerSet) {
+int Context::reduceProduction(Handler &handler) {
+    if (!handler.isEnd() && handler.current() != EMPTY) {
+        return -1;
+    }
+    int production = productionOf(handler);
+    if (production == -1) {
+        throw runtime_error("invalid production");
+    }
+    return production;
+}
+
+int Context::productionOf(const Handler &handler) {
+    auto found = sharedIndex.find(&handler.getProduction());
+    return found != sharedIndex.end() ? found->second : grammar.findProduction(handler.getProduction());
+}
+
+vector<int> Context::kernelCore(HandlerSet &state) {
+    vector<int> core{};
+    bool startState = std::none_of(state.ruleList().begin(), state.ruleList().end(),
+                                   [](const Handler &handler) { return handler.isKernel(); });
+    for (auto &handler : state.ruleList()) {
+        if (startState || handler.isKernel()) {
+            int production = productionOf(handler);
+            core.push_back(grammar.itemId(production, static_cast<int>(handler.getPosition())));
+        }
+    }
+    std::sort(core.begin(), core.end());
+    return core;
+}
+
+vector<HandlerSet> Context::Goto(const HandlerSet &currState) {
+    statistics.counters().gotoCalls++;
+    auto &handlers = currState.ruleList();
+    // the no terminals first and both kinds by symbol id
+    gotoSymbols.clear();
+    for (auto &h : handlers) {
+        if (!h.isEnd() && h.current() != EMPTY) {
+            gotoSymbols.push_back(h.current());
+        }
+    }
+    std::sort(gotoSymbols.begin(), gotoSymbols.end(), [](const Item &a1, const Item &a2) {
+        return a1.isNoTerminal() != a2.isNoTerminal() ? a1.isNoTerminal() : a1 < a2;
+    });
+    gotoSymbols.erase(std::unique(gotoSymbols.begin(), gotoSymbols.end()), gotoSymbols.end());
+
+    vector<HandlerSet> result{};
+    result.reserve(gotoSymbols.size());
+    for (auto &symbol : gotoSymbols) {
+        // the kernel goes straight to the closure engine's form, it only becomes handlers once closed
+        gotoKernel.clear();
+        for (auto &h : handlers) {
+            if (!h.isEnd() && h.current() == symbol) {
+                gotoKernel.push_back(toLrItem(h));
+                gotoKernel.back().position++;
+            }
+        }
+        auto closed = closeItems(gotoKernel);
+        result.emplace_back(symbol, toHandlers(*closed));
+    }
+    return result;
+}
+
+vector<Handler> Context::closureItemSet(const vector<Handler> &handlerSet) {
+    vector<LrItem> items{};
+    items.reserve(handlerSet.size());
+    for (auto &handler : handlerSet) {
+        items.push_back(toLrItem(handler));
+    }
+    return toHandlers(*closeItems(items));
+}
+
+vector<Handler> Context::toHandlers(const vector<LrItem> &items) {
     vector<Handler> result{};
-    result.reserve(20);
-    for (auto handler : handlerSet) {
-        auto closure = closureSet(handler, result);
+    result.reserve(items.size());
+    for (auto &item : items) {
+        result.push_back(toHandler(item));
     }
     return result;
 }
 
-vector<Handler> Context::closureSet(Handler &startHandler, vector<Handler> &result) {
-    bool hasChanged;
+vector<Handler> Context::closureSet(const Handler &startHandler, vector<Handler> &result) {
     if (startHandler.getLookForward().empty()) {
         throw runtime_error("invalid start handler");
     }
-    result.push_back(startHandler);
-    do {
-        hasChanged = false;
-        for (auto currentHandler:result) {
-            if (currentHandler.isEnd()) {
-                continue;
-            }
-            auto item = currentHandler.current();
-            auto bet = currentHandler.bet();
-            if (item.isNoTerminal()) {
-                auto pRules = rules(item);
-                for (auto &p : pRules) {
-                    Handler handler{p, 0};
-                    if (!bet) {
-                        handler.addLookForward(currentHandler.getLookForward().begin(),
-                                               currentHandler.getLookForward().end());
-                    } else {
-                        auto &val = bet.value();
-                        auto leftOpt = currentHandler.left();
-                        auto &leftVal = leftOpt.value();
-                        bool nullable = std::all_of(leftVal.begin(), leftVal.end(), [this](const Item &item) {
-                            return isNullable(item);
-                        });
-                        if (val.isNoTerminal() && nullable) {
-                            set<Item> lookItems{currentHandler.getLookForward().begin(),
-                                                currentHandler.getLookForward().end()};
-                            set<Item> firstSetAt{};
-                            for (auto &leftItem : leftVal) {
-                                lookItems.insert(firstAt(leftItem)->second.begin(), firstAt(leftItem)->second.end());
-                            }
-                            lookItems.insert(firstSetAt.begin(), firstSetAt.end());
-                            lookItems.erase(EMPTY);
-                            handler.addLookForward(lookItems.begin(), lookItems.end());
-                        } else if (val.isTerminal()) {
-                            handler.getLookForward().emplace(val);
-                        } else {
-                            set<Item> possLookItems{};
-                            for (auto &nextItem: leftVal) {
-                                auto firstAtItem = firstAt(nextItem);
-                                bool nextIsEmpty = nextItem == EMPTY;
-                                if ((nextItem.isNoTerminal() && isNullable(nextItem)) || nextIsEmpty) {
-                                    possLookItems.insert(firstAtItem->second.begin(), firstAtItem->second.end());
-                                } else if (nextItem.isNoTerminal()) {
-                                    possLookItems.insert(firstAtItem->second.begin(), firstAtItem->second.end());
-                                    break;
-                                } else {
-                                    possLookItems.emplace(nextItem);
-                                    break;
-                                }
-                            }
-                            possLookItems.erase(EMPTY);
-                            handler.addLookForward(possLookItems.begin(), possLookItems.end());
-                        }
-                    }
-                    auto ptr = find_if(result.begin(), result.end(), [&handler](Handler other) {
-                        bool itemEqual = other.getItem() == handler.getItem();
-                        if (!itemEqual) {
-                            return false;
-                        }
-                        bool productionSizeEqual = other.getProduction().size() == handler.getProduction().size();
-                        if (!productionSizeEqual) {
-                            return false;
-                        }
-                        bool productionEqual = std::equal(handler.getProduction().begin(),
-                                                          handler.getProduction().end(), other.getProduction().begin());
-                        if (!productionEqual) {
-                            return false;
-                        }
-
-                        return handler.getPosition() == other.getPosition();
-                    });
-                    if (ptr == result.end()) {
-
-                        hasChanged = true;
-                        result.emplace_back(handler);
-                    } else {
-                        auto &lookA1 = ptr->getLookForward();
-                        vector<Item> diff{};
-                        diff.reserve(10);
-                        std::set_difference(handler.getLookForward().begin(), handler.getLookForward().end(),
-                                            lookA1.begin(), lookA1.end(), std::back_inserter(diff));
-                        if (!diff.empty()) {
-                            hasChanged = true;
-                            result[std::distance(result.begin(), ptr)].getLookForward().insert(diff.begin(),
-                                                                                               diff.end());
-                        }
-                    }
-                }
-            }
+    vector<LrItem> items{};
+    items.reserve(result.size() + 1);
+    for (auto &handler : result) {
+        items.push_back(toLrItem(handler));
+    }
+    items.push_back(toLrItem(startHandler));
+    auto closed = closeItems(items);
+    result.clear();
+    for (auto &item : *closed) {
+        result.push_back(toHandler(item));
+    }
+    return result;
+}
+
+ClosureCache::Result Context::closeItems(const vector<LrItem> &kernel) {
+    prepareClosure();
+    auto cached = closureCache.find(kernel);
+    if (cached) {
+        statistics.counters().closureCacheHits++;
+        return cached;
+    }
+    vector<LrItem> items{};
+    // the closure is a few times the kernel, reserving avoids growing it item by item
+    items.reserve(kernel.size() * 4);
+    items.insert(items.end(), kernel.begin(), kernel.end());
+    closure.close(items);
+    return closureCache.insert(kernel, move(items));
+}
+
+void Context::collectClosureCounters(const ClosureEngine::Counters &counters) {
+    auto &total = statistics.counters();
+    total.closureCalls += counters.closes;
+    total.fixpointIterations += counters.iterations;
+    total.lookaheadMerges += counters.merges;
+}
+
+LrItem Context::toLrItem(const Handler &handler) {
+    int production = productionOf(handler);
+    if (production == -1) {
+        throw runtime_error("invalid production");
+    }
+    BitSet lookForward{grammar.terminals().size()};
+    for (auto &look : handler.getLookForward()) {
+        int index = grammar.terminalIndex(look.getId());
+        if (index != -1) {
+            lookForward.set(index);
         }
-    } while (hasChanged);
-    return
-            result;
+    }
+    return LrItem{production, handler.getPosition(), move(lookForward)};
 }
 
-std::vector<Production> Context::rules(const Item &item) {
-    vector<Production> result{};
-    copy_if(ruleList.begin(), ruleList.end(), back_inserter(result), [&item](Production other) {
-        return other.getName() == item.getName() && other.getItem().isTerminal() == item.isTerminal();
+Handler Context::toHandler(const LrItem &item) {
+    // the terminals are indexed by name, the interned set is sorted by id
+    lookScratch.clear();
+    item.lookForward.forEach([this](size_t index) {
+        lookScratch.emplace_back(grammar.terminals()[index]);
     });
-    return result;
+    std::sort(lookScratch.begin(), lookScratch.end());
+    return Handler::shared(*sharedRules[item.production], static_cast<size_t>(item.position),
+                           pool->intern(lookScratch.data(), lookScratch.data() + lookScratch.size()));
 }
 
-pair<Context::ActionTable, Context::GotoTable> Context::table(vector<HandlerSet> &state) {
-    using ActionItem = array<int, 2>;
-    using ItemName = string;
-    using ItemAction = pair<ItemName, ActionItem>;
-    using GotoAction = pair<ItemName, int>;
-    // 1 for accept
-    // 2 for shift
-    // 3 for reduce
-    auto gotoStat = [&](Item shift, vector<Handler> &handler) -> int {
-        auto handleSet = HandlerSet{std::move(shift), handler};;
-        auto nextGoto = Goto(handleSet);
-        if (nextGoto.size() != 1) {
-            throw runtime_error("invalid next state size");
+ParseTable Context::table(vector<HandlerSet> &state, size_t threads) {
+    auto phase = statistics.phase("table");
+    // shift and goto entries come from the transitions recorded by generalLr1()
+    auto gotoStat = [](HandlerSet &currState, const Item &item) -> int {
+        auto next = currState.transition(item);
+        if (next == -1) {
+            throw runtime_error("unknown goto state");
         }
-        for (auto &n : nextGoto) {
-            auto ptr = std::find(state.begin(), state.end(), n);
-            if (ptr == end(state)) {
-                throw runtime_error("unknown goto state");
-            }
-            return std::distance(state.begin(), ptr);
-        }
-        return -1;
+        return next;
     };
-    pair<Context::ActionTable, Context::GotoTable> result{Context::ActionTable{state.size()},
-                                                          Context::GotoTable{state.size()}};
-    auto &actionTable = result.first;
-    auto &gotoTable = result.second;
-    for (int i = 0; i < state.size(); i++) {
-        auto &currState = state[i];
-        auto &stateActionTable = actionTable[i];
-        auto &stateGotoTable = gotoTable[i];
-        for (auto item: currState.ruleList()) {
-            int parent = currState.getParentId();
+    ParseTable result{state.size(), grammar.terminals(), grammar.noTerminals()};
+    auto column = [this](const Item &item) { return grammar.terminalIndex(item.getId()); };
+    int eofColumn = column(Eof);
+    for (int p = 0; p < static_cast<int>(grammar.productionCount()); p++) {
+        auto &rhs = grammar.rhs(p);
+        auto length = std::count_if(rhs.begin(), rhs.end(), [this](int symbol) { return symbol != grammar.epsilon(); });
+        result.setProduction(p, grammar.noTerminalIndex(grammar.lhs(p)), static_cast<int>(length));
+    }
+    auto levels = precedence.productionLevels(grammar);
+    ThreadPool workers{threads};
+    // every row is filled by one worker. the actions of a cell are collected first and decided together,
+    // so the action it keeps does not depend on the item order
+    using Candidate = pair<int, ParseAction>;
+    vector<vector<Conflict>> workerConflicts(workers.size());
+    vector<size_t> workerResolved(workers.size(), 0);
+    vector<vector<Candidate>> workerCandidates(workers.size());
+    vector<vector<ParseAction>> workerCells(workers.size());
+    workers.parallelFor(state.size(), [&](size_t row, size_t worker) {
+        int i = static_cast<int>(row);
+        auto &currState = state[row];
+        auto &candidates = workerCandidates[worker];
+        candidates.clear();
+        for (auto &item: currState.ruleList()) {
             if (item.isEnd() &&
                 item.getItem() == start.getItem() &&
                 item.getLookForward().size() == 1 &&
-                item.getLookForward().find(Eof) != end(item.getLookForward())) {
-                stateActionTable.insert(ItemAction{"$", ActionItem{1, 0}});
-            } else if (item.isEnd()) {
-                auto &lookForward = item.getLookForward();
-                auto &production = item.getProduction();
-                auto ptr = find_if(ruleList.begin(), ruleList.end(), [&production](Production &prod) {
-                    if (production.size() != prod.size()) {
-                        return false;
-                    }
-                    return prod.getName() == production.getName() &&
-                           std::equal(prod.begin(), prod.end(), production.begin());
-                });
-                if (ptr == end(ruleList)) {
-                    throw runtime_error("invalid production");
-                }
-                int id = std::distance(ruleList.begin(), ptr);
-                for (auto &look : lookForward) {
-                    stateActionTable.insert(ItemAction{look.getName(), ActionItem{3, id}});
-                }
-            } else if (!item.isEnd() && item.current().isTerminal() &&
-                       std::any_of(item.getProduction().begin(), item.getProduction().end(),
-                                   [](const Item &item) { return item == EMPTY; })) {
-                auto &lookForward = item.getLookForward();
-                auto &production = item.getProduction();
-                auto ptr = find_if(ruleList.begin(), ruleList.end(), [&production](Production &prod) {
-                    if (production.size() != prod.size()) {
-                        return false;
-                    }
-                    return prod.getName() == production.getName() &&
-                           std::equal(prod.begin(), prod.end(), production.begin());
-                });
-                if (ptr == end(ruleList)) {
-                    throw runtime_error("invalid production");
+                item.getLookForward().count(Eof) != 0) {
+                candidates.emplace_back(eofColumn, ParseAction{ActionType::Accept, 0});
+            } else if (item.isEnd() || item.current() == EMPTY) {
+                int id = reduceProduction(item);
+                for (auto &look : item.getLookForward()) {
+                    candidates.emplace_back(column(look), ParseAction{ActionType::Reduce, id});
                 }
-                int id = std::distance(ruleList.begin(), ptr);
-                for (auto &look : lookForward) {
-                    stateActionTable.insert(ItemAction{look.getName(), ActionItem{3, id}});
+            } else if (item.current().isTerminal()) {
+                auto nextState = gotoStat(currState, item.current());
+                candidates.emplace_back(column(item.current()), ParseAction{ActionType::Shift, nextState});
+            } else if (item.current().isNoTerminal()) {
+                result.setGoto(i, grammar.noTerminalIndex(item.current().getId()), gotoStat(currState, item.current()));
+            }
+        }
+        // by column, then accept, shift and reduce, the reduces by production
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate &a, const Candidate &b) {
+            if (a.first != b.first) {
+                return a.first < b.first;
+            }
+            return a.second.type != b.second.type ? a.second.type < b.second.type : a.second.value < b.second.value;
+        });
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        auto &cell = workerCells[worker];
+        for (size_t begin = 0, end = 0; begin < candidates.size(); begin = end) {
+            int col = candidates[begin].first;
+            cell.clear();
+            for (end = begin; end < candidates.size() && candidates[end].first == col; end++) {
+                cell.push_back(candidates[end].second);
+            }
+            int symbol = grammar.terminals()[col];
+            bool resolved = false;
+            auto chosen = cell.size() == 1 ? cell.front() : precedence.choose(levels, symbol, cell, resolved);
+            if (chosen.type == ActionType::Error) {
+                // a %nonassoc conflict empties the cell
+                result.markExplicitError(i);
+            } else {
+                result.putAction(i, col, chosen);
+            }
+            if (resolved) {
+                workerResolved[worker]++;
+            }
+            // the shift and the lowest reduce the levels decided between are no conflict, every other action is
+            auto lowest = std::find_if(cell.begin(), cell.end(),
+                                       [](const ParseAction &action) { return action.type == ActionType::Reduce; });
+            for (auto ptr = cell.begin(); ptr != cell.end(); ++ptr) {
+                if (*ptr == chosen || (resolved && (ptr->type == ActionType::Shift || ptr == lowest))) {
+                    continue;
                 }
-            } else if (!item.isEnd() && item.current().isTerminal()) {
-                vector<Handler> sameCurrentHandlerList{};;
-                copy_if(currState.ruleList().begin(), currState.ruleList().end(),
-                        std::inserter(sameCurrentHandlerList, sameCurrentHandlerList.end()),
-                        [&item](Handler a1) {
-                            return !a1.isEnd() && a1.current() == item.current();
-                        });
-                auto nextState = gotoStat(item.current(), sameCurrentHandlerList);
-                stateActionTable.insert(ItemAction{item.current().getName(), ActionItem{2, nextState}});
-            } else if (!item.isEnd() && item.current().isNoTerminal()) {
-                vector<Handler> sameCurrentHandlerList{};;
-                copy_if(currState.ruleList().begin(), currState.ruleList().end(),
-                        std::inserter(sameCurrentHandlerList, sameCurrentHandlerList.end()),
-                        [&item](Handler a1) {
-                            return !a1.isEnd() && a1.current() == item.current();
-                        });
-                stateGotoTable.insert(
-                        {GotoAction{item.current().getName(), gotoStat(item.current(), sameCurrentHandlerList)}});
+                workerConflicts[worker].push_back(Conflict{i, symbol, chosen, *ptr});
             }
         }
+    });
+    // a row belongs to a single worker, ordering by state restores the serial order
+    conflictList.clear();
+    for (auto &list : workerConflicts) {
+        conflictList.insert(conflictList.end(), list.begin(), list.end());
+    }
+    std::stable_sort(conflictList.begin(), conflictList.end(),
+                     [](const Conflict &a, const Conflict &b) { return a.state < b.state; });
+    resolvedConflicts = 0;
+    for (auto count : workerResolved) {
+        resolvedConflicts += count;
     }
     return result;
 }
 
-void Context::printTable(pair<Context::ActionTable, Context::GotoTable> table) {
-    set<string> nt{};
-    set<string> t{Eof.getName()};
-    for (auto &p : ruleList) {
-        for (auto &i : p) {
-            if (i.isNoTerminal() && std::find(nt.begin(), nt.end(), i.getName()) == end(nt)) {
-                if (i == start.getItem()) {
-                    continue;
-                }
-                nt.insert(i.getName());
-            } else if (i.isTerminal() && std::find(t.begin(), t.end(), i.getName()) == end(t)) {
-                if (i == EMPTY) {
-                    continue;
-                }
-                t.insert(i.getName());
-            }
+void Context::declarePrecedence(Associativity associativity, const vector<Item> &terminals) {
+    vector<int> symbols{};
+    for (auto &item : terminals) {
+        if (!item.isTerminal()) {
+            throw runtime_error("precedence of the no terminal " + item.getName());
         }
+        symbols.push_back(item.getId());
+    }
+    precedence.declare(associativity, symbols);
+}
+
+void Context::setPrecedence(const Production &production, const Item &terminal) {
+    int id = grammar.findProduction(production);
+    if (id == -1) {
+        throw runtime_error("precedence of a production which is not a part of the grammar");
     }
+    if (!terminal.isTerminal()) {
+        throw runtime_error("precedence of the no terminal " + terminal.getName());
+    }
+    precedence.setProduction(id, terminal.getId());
+}
+
+void Context::printTable(const ParseTable &table) {
+    auto &t = grammar.terminals();
+    vector<int> nt{};
+    std::copy_if(grammar.noTerminals().begin(), grammar.noTerminals().end(), back_inserter(nt),
+                 [this](int symbol) { return symbol != grammar.startSymbol(); });
     int actionTableLength = static_cast<int>(t.size() + 2) * 20;
     int gotoTableLength = static_cast<int>(nt.size()) * 20;
     ::printf("\n%*s|%-*s\n", actionTableLength, "action", gotoTableLength, "goto");
     ::printf("%10s", "state");
-    for (auto &str: t) {
-        printf("|%18s|", str.c_str());
+    for (auto symbol: t) {
+        printf("|%18s|", grammar.name(symbol).c_str());
     }
     printf("|");
-    for (auto &str: nt) {
-        printf("|%18s|", str.c_str());
+    for (auto symbol: nt) {
+        printf("|%18s|", grammar.name(symbol).c_str());
     }
     printf("\n");
     char str[128];
-    for (int i = 0; i < table.first.size(); i++) {
-        auto &actionCurrent = table.first[i];
-        auto &gotoCurrent = table.second[i];
+    for (int i = 0; i < static_cast<int>(table.stateCount()); i++) {
         ::printf("%10d", i);
-        for (auto &name : t) {
+        for (auto symbol : t) {
             memset(str, 0, sizeof(str));
-            auto action = actionCurrent.find(name);
-            if (action != std::end(actionCurrent)) {
-                if (action->second[0] == 1) {
+            auto action = table.action(i, grammar.terminalIndex(symbol));
+            if (action.type != ActionType::Error) {
+                if (action.type == ActionType::Accept) {
                     // accept
                     strcpy(str, "a");
-                } else if (action->second[0] == 2) {
+                } else if (action.type == ActionType::Shift) {
                     strcpy(str, "s");
-                } else if (action->second[0] == 3) {
+                } else if (action.type == ActionType::Reduce) {
                     strcpy(str, "r");
                 }
-                ::printf("|%13s%-5d|", str, action->second[1]);
+                ::printf("|%13s%-5d|", str, action.value);
             } else {
                 ::printf("|%18s|", "");
             }
         }
         ::printf("|");
-        for (auto &name : nt) {
-            auto gotoAction = gotoCurrent.find(name);
-            if (gotoAction != std::end(gotoCurrent)) {
-                printf("|%18d|", gotoAction->second);
+        for (auto symbol : nt) {
+            auto gotoAction = table.goTo(i, grammar.noTerminalIndex(symbol));
+            if (gotoAction != -1) {
+                printf("|%18d|", gotoAction);
             } else {
                 printf("|%18s|", "");
             }
@@ -555,4 +705,3 @@ void Context::printTable(pair<Context::ActionTable, Context::GotoTable> table) {
     }
 
 }
-
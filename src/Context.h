@@ -5,21 +5,54 @@
 #include "Production.h"
 #include "Handler.h"
 #include "HandlerSet.h"
-#include <array>
+#include "InternPool.h"
+#include "Grammar.h"
+#include "FirstFollow.h"
+#include "StateIndex.h"
+#include "ClosureEngine.h"
+#include "ClosureCache.h"
+#include "ParseTable.h"
+#include "Precedence.h"
+#include "Statistics.h"
 #include <memory>
+#include <unordered_map>
 
 class Context {
 private:
 
     Production start;
     std::vector<Production> ruleList;
-    std::map<std::string, std::set<Item>> firstSet;
-    std::map<std::string, std::set<Item>> followSet;
+    Grammar grammar;
+    FirstFollow firstFollow;
+    ClosureEngine closure;
+    ClosureCache closureCache;
+    std::map<int, std::set<Item>> firstSet;
+    std::map<int, std::set<Item>> followSet;
+    Precedence precedence;
+    std::vector<Conflict> conflictList;
+    size_t resolvedConflicts = 0;
+    Statistics statistics;
+    // the pool the handlers of this context are interned into
+    std::shared_ptr<InternPool> pool;
+    // the interned copy of every rule and the rule index of every interned copy
+    std::vector<const Production *> sharedRules;
+    std::unordered_map<const Production *, int> sharedIndex;
+    // scratch buffers of the generation, reused from one state to the next
+    std::vector<Item> lookScratch;
+    std::vector<Item> gotoSymbols;
+    std::vector<LrItem> gotoKernel;
 public:
-    using ActionTable = std::vector<std::map<std::string, std::array<int, 2>>>;
-    using GotoTable = std::vector<std::map<std::string, int>>;
+    explicit Context(std::vector<Production> rules, Production startProduction);
 
-    explicit Context(std::vector<Production> grammar, Production startProduction);
+    // the closure engine and its cache point into the context, a copy would share them with the original
+    Context(const Context &) = delete;
+
+    Context &operator=(const Context &) = delete;
+
+    // a moved context keeps its prepared closure engine, pointed at the moved grammar
+    Context(Context &&other) noexcept;
+
+    Context &operator=(Context &&other) noexcept;
 
     void first();
 
@@ -35,34 +68,124 @@ public:
 
     std::vector<HandlerSet> generalLr1();
 
-    std::pair<ActionTable, GotoTable> table(std::vector<HandlerSet> &statSet);
+    // the states of generalLr1(), each breadth first level is expanded on a pool of threads, 0 uses every core.
+    // the numbering does not depend on the thread count
+    std::vector<HandlerSet> generateLr1Parallel(size_t threads = 0);
+
+    // the lr(0) states with lalr(1) look forward sets, the table is built by table() as for generalLr1()
+    std::vector<HandlerSet> generateLalr1();
+
+    // lr(1) states merged by Pager's weak compatibility, close to the lalr(1) state count without its conflicts
+    std::vector<HandlerSet> generateMinimalLr1();
+
+    // the reduce/reduce conflicts of the lalr(1) states which no canonical lr(1) state with the same core has
+    std::vector<Conflict> lalrConflicts(std::vector<HandlerSet> &lalrStates);
+
+    // fills the rows on threads workers, 0 uses every core. shift/reduce conflicts are decided by the
+    // precedence levels, a %nonassoc one leaves the cell empty. the rest keep the shift or the reduce by the
+    // lower production and are reported in getConflicts()
+    ParseTable table(std::vector<HandlerSet> &statSet, size_t threads = 1);
+
+    // the conflicts of the last table() the precedence levels did not decide, ordered by state.
+    // first is the action the cell kept
+    const std::vector<Conflict> &getConflicts() const {
+        return conflictList;
+    }
 
-    auto firstAt(const Item &item)
+    // the number of conflicts of the last table() the precedence levels decided
+    size_t getResolvedConflicts() const {
+        return resolvedConflicts;
+    }
 
-    -> decltype(firstSet.begin());
+    // a new %left/%right/%nonassoc level for terminals, binding tighter than the levels declared before
+    void declarePrecedence(Associativity associativity, const std::vector<Item> &terminals);
+
+    // %prec, production takes the level of terminal instead of the one of its last terminal
+    void setPrecedence(const Production &production, const Item &terminal);
+
+    auto firstAt(const Item &item) -> decltype(firstSet.begin());
 
     auto firstAt(const std::string &name) -> decltype(firstSet.begin());
 
+    bool firstExist(const Item &item);
+
+    bool firstExist(const std::string &name);
+
     auto followAt(const Item &item) -> decltype(followSet.begin());
 
     auto followAt(const std::string &name) -> decltype(followSet.begin());
 
-    std::vector<Handler> closureSet(Handler &startHandler, std::vector<Handler> &result);
+    std::vector<Handler> closureSet(const Handler &startHandler, std::vector<Handler> &result);
+
+    std::vector<Handler> closureItemSet(const std::vector<Handler> &handlerSet);
+
+    // the successors of a state, no terminals first and both kinds by symbol id
+    std::vector<HandlerSet> Goto(const HandlerSet &currencyHandler);
 
-    std::vector<Handler> closureItemSet(std::vector<Handler> &handlerSet);
+    void printTable(const ParseTable &table);
 
-    std::vector<HandlerSet> Goto(HandlerSet currencyHandler);
+    const Grammar &getGrammar() const {
+        return grammar;
+    }
 
-    void printTable(std::pair<ActionTable, GotoTable> table);
+    const std::vector<Production> &getRules() const {
+        return ruleList;
+    }
+
+    const Production &getStart() const {
+        return start;
+    }
+
+    const Precedence &getPrecedence() const {
+        return precedence;
+    }
+
+    const ClosureCache &getClosureCache() const {
+        return closureCache;
+    }
+
+    // the phases run and the work done by this context since it was created or clearStatistics() was called.
+    // the goto and dedup counters cover generalLr1() and generateLr1Parallel()
+    const Statistics &getStatistics() const {
+        return statistics;
+    }
+
+    void clearStatistics() {
+        statistics.clear();
+    }
+
+    // bounds the memory the closure cache may use, 0 disables the cache
+    void setClosureCacheLimit(size_t bytes) {
+        closureCache.setByteLimit(bytes);
+    }
 
 private:
 
-    std::vector<Production> rules(const Item &item);
+    // prepares the closure engine once, after the first sets it is built from
+    void prepareClosure();
 
+    ClosureCache::Result closeItems(const std::vector<LrItem> &kernel);
 
-    bool firstExist(const Item &item);
+    // moves the work counted by the closure engine into the statistics
+    void collectClosureCounters(const ClosureEngine::Counters &counters);
+
+    std::vector<HandlerSet> toHandlerSets(std::vector<LrState> &states);
+
+    LrItem toLrItem(const Handler &handler);
+
+    std::vector<Handler> toHandlers(const std::vector<LrItem> &items);
+
+    int reduceProduction(Handler &handler);
+
+    // the rule index of the production of handler, -1 if it is not a rule of the grammar
+    int productionOf(const Handler &handler);
+
+    std::vector<int> kernelCore(HandlerSet &state);
+
+    Handler toHandler(const LrItem &item);
+
+    int symbolOf(const std::string &name);
 
-    bool firstExist(const std::string &name);
 };
 
 #endif
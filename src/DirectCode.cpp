@@ -0,0 +1,150 @@
+#include "DirectCode.h"
+#include "Quote.h"
+#include "SymbolTable.h"
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+using std::map;
+using std::endl;
+
+DirectCodeGenerator::DirectCodeGenerator(const ParseTable &tableRef, int eofSymbol)
+        : table(tableRef), eofColumn{tableRef.terminalColumn(eofSymbol)} {
+    if (eofColumn == -1) {
+        throw std::runtime_error("unknown end of input symbol");
+    }
+}
+
+string DirectCodeGenerator::generate(const string &name) const {
+    auto states = static_cast<int>(table.stateCount());
+    auto terminals = static_cast<int>(table.terminalCount());
+    auto noTerminals = static_cast<int>(table.noTerminalCount());
+    std::ostringstream out{};
+    out << "// generated by DirectCodeGenerator, do not edit" << endl
+        << "#pragma once" << endl << endl
+        << "#include <cstddef>" << endl
+        << "#include <vector>" << endl << endl
+        << "namespace " << name << " {" << endl << endl
+        << "constexpr int terminalCount = " << terminals << ";" << endl
+        << "constexpr int eofColumn = " << eofColumn << ";" << endl << endl
+        << "// the name of every terminal column" << endl
+        << "constexpr const char *terminalNames[] = {" << endl;
+    for (auto symbol : table.terminals()) {
+        out << "        " << quote(SymbolTable::global().name(symbol)) << "," << endl;
+    }
+    out << "};" << endl << endl
+        << "struct Result {" << endl
+        << "    bool accepted;" << endl
+        << "    size_t position;" << endl
+        << "};" << endl << endl
+        << "// columns are terminal columns, the end of input is implied after the last one." << endl
+        << "// reduce(production, begin, end) is called with the token range of every reduce," << endl
+        << "// the stacks are reused between calls and grow when a parse nests deeper than them" << endl
+        << "template<typename Reduce>" << endl
+        << "Result parse(const int *columns, size_t count, std::vector<int> &stateStack, "
+        << "std::vector<size_t> &startStack, Reduce &&reduce) {" << endl
+        << "    if (stateStack.size() < 2 || startStack.size() != stateStack.size()) {" << endl
+        << "        stateStack.resize(stateStack.size() < 2 ? 64 : stateStack.size());" << endl
+        << "        startStack.resize(stateStack.size());" << endl
+        << "    }" << endl
+        << "    int *state = stateStack.data();" << endl
+        << "    size_t *start = startStack.data();" << endl
+        << "    size_t capacity = stateStack.size();" << endl
+        << "    size_t top = 0;" << endl
+        << "    size_t position = 0;" << endl
+        << "    size_t first = 0;" << endl
+        << "    int lookahead = count != 0 ? columns[0] : eofColumn;" << endl
+        << "    auto push = [&](int next, size_t from) {" << endl
+        << "        if (++top == capacity) {" << endl
+        << "            capacity *= 2;" << endl
+        << "            stateStack.resize(capacity);" << endl
+        << "            startStack.resize(capacity);" << endl
+        << "            state = stateStack.data();" << endl
+        << "            start = startStack.data();" << endl
+        << "        }" << endl
+        << "        state[top] = next;" << endl
+        << "        start[top] = from;" << endl
+        << "    };" << endl
+        << "    auto advance = [&]() {" << endl
+        << "        ++position;" << endl
+        << "        lookahead = position < count ? columns[position] : eofColumn;" << endl
+        << "    };" << endl
+        << "    state[0] = 0;" << endl
+        << "    start[0] = 0;" << endl
+        << "    goto state_0;" << endl;
+
+    vector<char> reduced(noTerminals, 0);
+    for (int s = 0; s < states; s++) {
+        out << "state_" << s << ":" << endl
+            << "    switch (lookahead) {" << endl;
+        // the columns reducing by the same production share one case block, the default reduction takes the
+        // default label of the switch
+        map<int, vector<int>> reduces{};
+        int fallback = table.defaultReduction(s);
+        if (fallback != -1) {
+            reduces[fallback];
+        }
+        for (int column = 0; column < terminals; column++) {
+            auto action = table.action(s, column);
+            if (action.type == ActionType::Shift) {
+                out << "        case " << column << ":" << endl
+                    << "            push(" << action.value << ", position);" << endl
+                    << "            advance();" << endl
+                    << "            goto state_" << action.value << ";" << endl;
+            } else if (action.type == ActionType::Accept) {
+                out << "        case " << column << ":" << endl
+                    << "            return Result{true, position};" << endl;
+            } else if (action.type == ActionType::Reduce) {
+                reduces[action.value].push_back(column);
+            }
+        }
+        for (auto &reduce : reduces) {
+            int production = reduce.first;
+            int length = table.reduceLength(production);
+            int lhs = table.reduceColumn(production);
+            reduced[lhs] = 1;
+            for (auto column : reduce.second) {
+                out << "        case " << column << ":" << endl;
+            }
+            if (production == fallback) {
+                out << "        default:" << endl;
+            }
+            if (length == 0) {
+                out << "            first = position;" << endl;
+            } else {
+                out << "            top -= " << length << ";" << endl
+                    << "            first = start[top + 1];" << endl;
+            }
+            out << "            reduce(" << production << ", first, position);" << endl
+                << "            goto goto_" << lhs << ";" << endl;
+        }
+        if (fallback == -1) {
+            out << "        default:" << endl
+                << "            return Result{false, position};" << endl;
+        }
+        out << "    }" << endl;
+    }
+    for (int column = 0; column < noTerminals; column++) {
+        if (!reduced[column]) {
+            continue;
+        }
+        out << "goto_" << column << ":" << endl
+            << "    switch (state[top]) {" << endl;
+        for (int s = 0; s < states; s++) {
+            int next = table.goTo(s, column);
+            if (next != -1) {
+                out << "        case " << s << ":" << endl
+                    << "            push(" << next << ", first);" << endl
+                    << "            goto state_" << next << ";" << endl;
+            }
+        }
+        out << "        default:" << endl
+            << "            return Result{false, position};" << endl
+            << "    }" << endl;
+    }
+    out << "}" << endl << endl
+        << "}" << endl;
+    return out.str();
+}
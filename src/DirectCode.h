@@ -0,0 +1,23 @@
+#ifndef DIRECT_CODE_H
+#define DIRECT_CODE_H
+
+#include "ParseTable.h"
+#include <string>
+
+// turns a ParseTable into a directly coded c++ parser.
+// every state becomes a label with a switch over the lookahead column where shifts, reduces and accept
+// are written out, a default reduction is the default label. every no terminal gets a switch over the exposed
+// state for its goto entries.
+// the output is a header with parse() in namespace name, it only needs the standard library.
+class DirectCodeGenerator {
+public:
+    DirectCodeGenerator(const ParseTable &table, int eofSymbol);
+
+    std::string generate(const std::string &name) const;
+
+private:
+    const ParseTable &table;
+    int eofColumn;
+};
+
+#endif
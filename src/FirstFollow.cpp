@@ -0,0 +1,147 @@
+#include "FirstFollow.h"
+#include <deque>
+
+using std::vector;
+using std::deque;
+
+void FirstFollow::computeFirst(const Grammar &grammar) {
+    auto bound = grammar.symbolBound();
+    width = grammar.terminals().size();
+    updateCount = 0;
+    none = BitSet{width};
+    firstList.assign(bound, BitSet{width});
+    nullableList.assign(bound, 0);
+    for (auto t : grammar.terminals()) {
+        firstList[t].set(grammar.terminalIndex(t));
+    }
+    nullableList[grammar.epsilon()] = 1;
+
+    // users[X] are the productions which have to be revisited once FIRST(X) grows
+    vector<vector<int>> users(bound);
+    for (int p = 0; p < static_cast<int>(grammar.productionCount()); p++) {
+        for (auto symbol : grammar.rhs(p)) {
+            if (!grammar.isTerminal(symbol) && (users[symbol].empty() || users[symbol].back() != p)) {
+                users[symbol].push_back(p);
+            }
+        }
+    }
+    deque<int> work{};
+    vector<char> queued(grammar.productionCount(), 1);
+    for (int p = 0; p < static_cast<int>(grammar.productionCount()); p++) {
+        work.push_back(p);
+    }
+    while (!work.empty()) {
+        int p = work.front();
+        work.pop_front();
+        queued[p] = 0;
+        int lhs = grammar.lhs(p);
+        auto &rhs = grammar.rhs(p);
+        updateCount++;
+        bool changed = false;
+        bool allNullable = true;
+        for (auto symbol : rhs) {
+            if (symbol != lhs) {
+                changed = firstList[lhs].unionWith(firstList[symbol]) || changed;
+            }
+            if (!nullableList[symbol]) {
+                allNullable = false;
+                break;
+            }
+        }
+        if (allNullable && !nullableList[lhs]) {
+            nullableList[lhs] = 1;
+            changed = true;
+        }
+        if (!changed) {
+            continue;
+        }
+        for (auto user : users[lhs]) {
+            if (!queued[user]) {
+                queued[user] = 1;
+                work.push_back(user);
+            }
+        }
+    }
+}
+
+void FirstFollow::computeFollow(const Grammar &grammar) {
+    auto bound = grammar.symbolBound();
+    followList.assign(bound, BitSet{width});
+    followList[grammar.startSymbol()].set(grammar.terminalIndex(grammar.eof()));
+
+    // FOLLOW(X) gets FIRST of the symbols behind X directly, FOLLOW(A) flows into FOLLOW(X)
+    // along the edges A -> X for every production A -> αXβ with a nullable β.
+    vector<vector<int>> edges(bound);
+    for (int p = 0; p < static_cast<int>(grammar.productionCount()); p++) {
+        int lhs = grammar.lhs(p);
+        auto &rhs = grammar.rhs(p);
+        BitSet tail{width};
+        bool tailNullable = true;
+        for (int j = static_cast<int>(rhs.size()) - 1; j >= 0; j--) {
+            int symbol = rhs[j];
+            if (!grammar.isTerminal(symbol)) {
+                followList[symbol].unionWith(tail);
+                if (tailNullable && symbol != lhs) {
+                    edges[lhs].push_back(symbol);
+                }
+            }
+            if (symbol == grammar.epsilon()) {
+                continue;
+            }
+            if (!nullableList[symbol]) {
+                tail.clear();
+                tailNullable = false;
+            }
+            tail.unionWith(firstList[symbol]);
+        }
+    }
+    deque<int> work{};
+    vector<char> queued(bound, 0);
+    for (auto n : grammar.noTerminals()) {
+        queued[n] = 1;
+        work.push_back(n);
+    }
+    while (!work.empty()) {
+        int symbol = work.front();
+        work.pop_front();
+        queued[symbol] = 0;
+        updateCount++;
+        for (auto next : edges[symbol]) {
+            if (followList[next].unionWith(followList[symbol]) && !queued[next]) {
+                queued[next] = 1;
+                work.push_back(next);
+            }
+        }
+    }
+}
+
+const BitSet &FirstFollow::first(int symbol) const {
+    if (symbol < 0 || symbol >= static_cast<int>(firstList.size())) {
+        return none;
+    }
+    return firstList[symbol];
+}
+
+bool FirstFollow::nullable(int symbol) const {
+    if (symbol < 0 || symbol >= static_cast<int>(nullableList.size())) {
+        return false;
+    }
+    return nullableList[symbol] != 0;
+}
+
+const BitSet &FirstFollow::follow(int symbol) const {
+    if (symbol < 0 || symbol >= static_cast<int>(followList.size())) {
+        return none;
+    }
+    return followList[symbol];
+}
+
+bool FirstFollow::firstOf(const int *begin, const int *end, BitSet &result) const {
+    for (auto ptr = begin; ptr != end; ptr++) {
+        result.unionWith(first(*ptr));
+        if (!nullable(*ptr)) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,41 @@
+#ifndef FIRST_FOLLOW_H
+#define FIRST_FOLLOW_H
+
+#include "Grammar.h"
+#include "BitSet.h"
+
+// FIRST/FOLLOW sets stored as bit sets over the terminal indexes of the grammar.
+// both sets are solved with a worklist, a no terminal is only revisited when one of the sets it depends on grew.
+class FirstFollow {
+public:
+    void computeFirst(const Grammar &grammar);
+
+    void computeFollow(const Grammar &grammar);
+
+    const BitSet &first(int symbol) const;
+
+    bool nullable(int symbol) const;
+
+    const BitSet &follow(int symbol) const;
+
+    // adds FIRST(begin...end) to result and returns whether the whole sequence is nullable
+    bool firstOf(const int *begin, const int *end, BitSet &result) const;
+
+    size_t terminalCount() const {
+        return width;
+    }
+
+    size_t updates() const {
+        return updateCount;
+    }
+
+private:
+    size_t width = 0;
+    size_t updateCount = 0;
+    std::vector<BitSet> firstList;
+    std::vector<char> nullableList;
+    std::vector<BitSet> followList;
+    BitSet none;
+};
+
+#endif
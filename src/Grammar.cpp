@@ -0,0 +1,161 @@
+#include "Grammar.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+extern const Item EMPTY;
+extern const Item Eof;
+
+using std::vector;
+using std::string;
+using std::sort;
+using std::max;
+using std::runtime_error;
+using std::move;
+
+static const vector<int> noProduction{};
+
+template<typename Iterator, typename Id>
+static size_t productionHash(int lhs, Iterator begin, Iterator end, Id id) {
+    size_t result = static_cast<size_t>(lhs) * 0x9e3779b97f4a7c15ull;
+    for (auto ptr = begin; ptr != end; ptr++) {
+        result = (result ^ static_cast<size_t>(id(*ptr))) * 1099511628211ull;
+    }
+    return result;
+}
+
+Grammar::Grammar(const vector<Production> &rules, const Production &startProduction) :
+        lhsList{},
+        rhsList{},
+        productionIndex{},
+        productionLookup{},
+        itemOffset{},
+        terminalList{},
+        noTerminalList{},
+        columnList{},
+        terminalFlag{},
+        start{startProduction.getItem().getId()},
+        startRule{-1},
+        empty{EMPTY.getId()},
+        eofSymbol{Eof.getId()} {
+    int bound = max(max(start, empty), eofSymbol);
+    for (auto &p : rules) {
+        bound = max(bound, p.getItem().getId());
+        for (auto &i : p) {
+            bound = max(bound, i.getId());
+        }
+    }
+    columnList.assign(bound + 1, -1);
+    terminalFlag.assign(bound + 1, 0);
+    productionIndex.resize(bound + 1);
+
+    auto addSymbol = [this](const Item &item) {
+        int id = item.getId();
+        if (columnList[id] != -1 || id == empty) {
+            return;
+        }
+        columnList[id] = 0;
+        if (item.isTerminal()) {
+            terminalFlag[id] = 1;
+            terminalList.push_back(id);
+        } else {
+            noTerminalList.push_back(id);
+        }
+    };
+    addSymbol(Eof);
+    addSymbol(startProduction.getItem());
+    terminalFlag[empty] = 1;
+    lhsList.reserve(rules.size());
+    rhsList.reserve(rules.size());
+    for (auto &p : rules) {
+        int id = static_cast<int>(lhsList.size());
+        addSymbol(p.getItem());
+        vector<int> handle{};
+        handle.reserve(p.size());
+        for (auto &i : p) {
+            addSymbol(i);
+            handle.push_back(i.getId());
+        }
+        if (startRule == -1 && p.getItem() == startProduction.getItem()) {
+            startRule = id;
+        }
+        lhsList.push_back(p.getItem().getId());
+        auto hash = productionHash(lhsList.back(), handle.begin(), handle.end(), [](int symbol) { return symbol; });
+        rhsList.emplace_back(move(handle));
+        productionIndex[lhsList.back()].push_back(id);
+        productionLookup[hash].push_back(id);
+    }
+    itemOffset.reserve(rules.size() + 1);
+    itemOffset.push_back(0);
+    for (auto &handle : rhsList) {
+        itemOffset.push_back(itemOffset.back() + static_cast<int>(handle.size()) + 1);
+    }
+    if (startRule == -1) {
+        throw runtime_error("start production is not a part of the grammar");
+    }
+
+    auto byName = [](int a1, int a2) {
+        return SymbolTable::global().name(a1) < SymbolTable::global().name(a2);
+    };
+    sort(terminalList.begin(), terminalList.end(), byName);
+    sort(noTerminalList.begin(), noTerminalList.end(), byName);
+    for (int i = 0; i < static_cast<int>(terminalList.size()); i++) {
+        columnList[terminalList[i]] = i;
+    }
+    for (int i = 0; i < static_cast<int>(noTerminalList.size()); i++) {
+        columnList[noTerminalList[i]] = i;
+    }
+}
+
+const vector<int> &Grammar::productionsOf(int symbol) const {
+    if (symbol < 0 || symbol >= static_cast<int>(productionIndex.size())) {
+        return noProduction;
+    }
+    return productionIndex[symbol];
+}
+
+int Grammar::findProduction(const Production &production) const {
+    int lhs = production.getItem().getId();
+    auto hash = productionHash(lhs, production.begin(), production.end(), [](const Item &item) {
+        return item.getId();
+    });
+    auto ptr = productionLookup.find(hash);
+    if (ptr == productionLookup.end()) {
+        return -1;
+    }
+    for (auto id : ptr->second) {
+        auto &handle = rhsList[id];
+        if (lhsList[id] == lhs && handle.size() == production.size() &&
+            std::equal(handle.begin(), handle.end(), production.begin(), [](int symbol, const Item &item) {
+                return symbol == item.getId();
+            })) {
+            return id;
+        }
+    }
+    return -1;
+}
+
+int Grammar::terminalIndex(int symbol) const {
+    if (symbol < 0 || symbol >= static_cast<int>(columnList.size()) || !terminalFlag[symbol]) {
+        return -1;
+    }
+    return columnList[symbol];
+}
+
+int Grammar::noTerminalIndex(int symbol) const {
+    if (symbol < 0 || symbol >= static_cast<int>(columnList.size()) || terminalFlag[symbol]) {
+        return -1;
+    }
+    return columnList[symbol];
+}
+
+bool Grammar::isTerminal(int symbol) const {
+    if (symbol < 0 || symbol >= static_cast<int>(terminalFlag.size())) {
+        return SymbolTable::global().type(symbol) == ItemType::Terminal;
+    }
+    return terminalFlag[symbol] != 0;
+}
+
+const string &Grammar::name(int symbol) const {
+    return SymbolTable::global().name(symbol);
+}
@@ -0,0 +1,92 @@
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include "Common.h"
+#include "Production.h"
+#include <unordered_map>
+
+// integer view of a grammar. every symbol is referred by its SymbolTable id, the terminals and
+// the no terminals additionally get a dense index which is used as the column of the tables.
+class Grammar {
+public:
+    Grammar(const std::vector<Production> &rules, const Production &startProduction);
+
+    size_t productionCount() const {
+        return lhsList.size();
+    }
+
+    int lhs(int production) const {
+        return lhsList[production];
+    }
+
+    const std::vector<int> &rhs(int production) const {
+        return rhsList[production];
+    }
+
+    const std::vector<int> &productionsOf(int symbol) const;
+
+    // the id of the first production with the same left and right hand side, -1 if there is none
+    int findProduction(const Production &production) const;
+
+    // every (production, position) pair gets an id in [0, itemBound())
+    int itemId(int production, int position) const {
+        return itemOffset[production] + position;
+    }
+
+    size_t itemBound() const {
+        return itemOffset.empty() ? 0 : itemOffset.back();
+    }
+
+    const std::vector<int> &terminals() const {
+        return terminalList;
+    }
+
+    const std::vector<int> &noTerminals() const {
+        return noTerminalList;
+    }
+
+    int terminalIndex(int symbol) const;
+
+    int noTerminalIndex(int symbol) const;
+
+    bool isTerminal(int symbol) const;
+
+    size_t symbolBound() const {
+        return columnList.size();
+    }
+
+    int startSymbol() const {
+        return start;
+    }
+
+    int startProduction() const {
+        return startRule;
+    }
+
+    int epsilon() const {
+        return empty;
+    }
+
+    int eof() const {
+        return eofSymbol;
+    }
+
+    const std::string &name(int symbol) const;
+
+private:
+    std::vector<int> lhsList;
+    std::vector<std::vector<int>> rhsList;
+    std::vector<std::vector<int>> productionIndex;
+    std::unordered_map<size_t, std::vector<int>> productionLookup;
+    std::vector<int> itemOffset;
+    std::vector<int> terminalList;
+    std::vector<int> noTerminalList;
+    std::vector<int> columnList;
+    std::vector<char> terminalFlag;
+    int start;
+    int startRule;
+    int empty;
+    int eofSymbol;
+};
+
+#endif
@@ -0,0 +1,420 @@
+#include "GrammarFile.h"
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern const Item EMPTY;
+using std::string;
+using std::string_view;
+using std::vector;
+using std::unordered_map;
+using std::runtime_error;
+
+GrammarError::GrammarError(const string &source, size_t line, size_t column, const string &message)
+        : runtime_error(source + ":" + std::to_string(line) + ":" + std::to_string(column) + ": " + message),
+          lineNumber{line}, columnNumber{column} {
+}
+
+namespace {
+
+enum class TokenKind {
+    Word,
+    Quoted,
+    Epsilon,
+    Define,
+    Bar,
+    Directive,
+    End,
+};
+
+struct Token {
+    TokenKind kind;
+    string_view text;
+    size_t line;
+    size_t column;
+};
+
+constexpr string_view epsilonWord{"\xce\xb5"};
+constexpr string_view acuteAccent{"\xc2\xb4"};
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+bool isQuote(char c) {
+    return c == '`' || c == '\'' || c == '"';
+}
+
+// splits the text into tokens with two tokens of look ahead, the texts point into the source
+class Lexer {
+public:
+    Lexer(const char *textBegin, const char *textEnd, const string &sourceName)
+            : ptr(textBegin), end(textEnd), lineStart(textBegin), source(sourceName) {
+        ahead = scan();
+        after = scan();
+    }
+
+    Token next() {
+        Token result = ahead;
+        ahead = after;
+        if (after.kind != TokenKind::End) {
+            after = scan();
+        }
+        return result;
+    }
+
+    const Token &peek() const {
+        return ahead;
+    }
+
+    const Token &peekSecond() const {
+        return after;
+    }
+
+    [[noreturn]] void fail(const Token &at, const string &message) const {
+        throw GrammarError{source, at.line, at.column, message};
+    }
+
+private:
+    Token scan() {
+        skipSpaceAndComments();
+        Token token{TokenKind::End, string_view{}, line, static_cast<size_t>(ptr - lineStart) + 1};
+        if (ptr == end) {
+            return token;
+        }
+        if (*ptr == '|') {
+            token.kind = TokenKind::Bar;
+            token.text = string_view{ptr++, 1};
+            return token;
+        }
+        if (isQuote(*ptr)) {
+            char open = *ptr++;
+            const char *first = ptr;
+            while (true) {
+                if (ptr == end || *ptr == '\n') {
+                    fail(token, "unterminated quoted symbol");
+                }
+                if (*ptr == open) {
+                    token.text = string_view{first, static_cast<size_t>(ptr - first)};
+                    ptr++;
+                    break;
+                }
+                if (open == '`' && startsWith(acuteAccent)) {
+                    token.text = string_view{first, static_cast<size_t>(ptr - first)};
+                    ptr += acuteAccent.size();
+                    break;
+                }
+                ptr++;
+            }
+            if (token.text.empty()) {
+                fail(token, "empty quoted symbol");
+            }
+            token.kind = TokenKind::Quoted;
+            return token;
+        }
+        const char *first = ptr;
+        while (ptr != end && !isSpace(*ptr) && *ptr != '|' && !isQuote(*ptr)) {
+            ptr++;
+        }
+        token.text = string_view{first, static_cast<size_t>(ptr - first)};
+        if (token.text == "::=") {
+            token.kind = TokenKind::Define;
+        } else if (token.text == epsilonWord) {
+            token.kind = TokenKind::Epsilon;
+        } else if (token.text == "%left" || token.text == "%right" || token.text == "%nonassoc" ||
+                   token.text == "%prec") {
+            token.kind = TokenKind::Directive;
+        } else {
+            token.kind = TokenKind::Word;
+        }
+        return token;
+    }
+
+    void skipSpaceAndComments() {
+        while (ptr != end) {
+            if (*ptr == '\n') {
+                line++;
+                lineStart = ++ptr;
+            } else if (isSpace(*ptr)) {
+                ptr++;
+            } else if (startsWith("//")) {
+                auto newline = static_cast<const char *>(std::memchr(ptr, '\n', end - ptr));
+                ptr = newline == nullptr ? end : newline;
+            } else {
+                break;
+            }
+        }
+    }
+
+    bool startsWith(string_view text) const {
+        return static_cast<size_t>(end - ptr) >= text.size() && std::memcmp(ptr, text.data(), text.size()) == 0;
+    }
+
+    const char *ptr;
+    const char *end;
+    const char *lineStart;
+    size_t line = 1;
+    const string &source;
+    Token ahead{};
+    Token after{};
+};
+
+struct RawSymbol {
+    string_view name;
+    bool quoted;
+    GrammarFile::Location location;
+};
+
+struct RawProduction {
+    int rule;
+    size_t begin;
+    size_t end;
+    GrammarFile::Location location;
+    // the %prec terminal, an empty name if there is none
+    RawSymbol precedence;
+};
+
+struct RawLevel {
+    Associativity associativity;
+    vector<RawSymbol> terminals;
+};
+
+RawSymbol rawSymbol(const Token &token) {
+    return RawSymbol{token.text, token.kind == TokenKind::Quoted, GrammarFile::Location{token.line, token.column}};
+}
+
+// the symbols of a declaration run until the next rule or declaration
+bool declaresSymbol(const Lexer &lexer) {
+    auto kind = lexer.peek().kind;
+    return kind == TokenKind::Quoted || (kind == TokenKind::Word && lexer.peekSecond().kind != TokenKind::Define);
+}
+
+}
+
+GrammarFile GrammarFile::parse(const char *begin, const char *end, const string &source) {
+    Lexer lexer{begin, end, source};
+    vector<string_view> ruleNames{};
+    unordered_map<string_view, int> ruleIndex{};
+    vector<RawSymbol> symbols{};
+    vector<RawProduction> rawProductions{};
+    vector<RawLevel> rawLevels{};
+
+    while (lexer.peek().kind != TokenKind::End) {
+        if (lexer.peek().kind == TokenKind::Directive) {
+            auto directive = lexer.next();
+            if (directive.text == "%prec") {
+                lexer.fail(directive, "%prec has to end an alternative");
+            }
+            RawLevel level{directive.text == "%left" ? Associativity::Left : directive.text == "%right"
+                                                                             ? Associativity::Right
+                                                                             : Associativity::NonAssoc,
+                           vector<RawSymbol>{}};
+            while (declaresSymbol(lexer)) {
+                level.terminals.push_back(rawSymbol(lexer.next()));
+            }
+            if (level.terminals.empty()) {
+                lexer.fail(lexer.peek(), "expected the terminals of " + string{directive.text});
+            }
+            rawLevels.push_back(std::move(level));
+            continue;
+        }
+        auto name = lexer.next();
+        if (name.kind != TokenKind::Word) {
+            lexer.fail(name, "expected a rule name");
+        }
+        auto define = lexer.next();
+        if (define.kind != TokenKind::Define) {
+            lexer.fail(define, "expected ::= after " + string{name.text});
+        }
+        auto inserted = ruleIndex.emplace(name.text, static_cast<int>(ruleNames.size()));
+        if (inserted.second) {
+            ruleNames.push_back(name.text);
+        }
+        int rule = inserted.first->second;
+        while (true) {
+            auto &first = lexer.peek();
+            RawProduction production{rule, symbols.size(), symbols.size(), Location{first.line, first.column},
+                                     RawSymbol{string_view{}, false, Location{0, 0}}};
+            bool epsilon = false;
+            while (true) {
+                auto &token = lexer.peek();
+                // a word followed by ::= starts the next rule
+                if (token.kind == TokenKind::Word && lexer.peekSecond().kind == TokenKind::Define) {
+                    break;
+                }
+                if (token.kind == TokenKind::Word || token.kind == TokenKind::Quoted) {
+                    auto symbol = lexer.next();
+                    if (epsilon) {
+                        lexer.fail(symbol, "ε has to be the only symbol of an alternative");
+                    }
+                    symbols.push_back(rawSymbol(symbol));
+                } else if (token.kind == TokenKind::Directive && token.text == "%prec") {
+                    lexer.next();
+                    if (lexer.peek().kind != TokenKind::Word && lexer.peek().kind != TokenKind::Quoted) {
+                        lexer.fail(lexer.peek(), "expected a terminal after %prec");
+                    }
+                    production.precedence = rawSymbol(lexer.next());
+                    if (declaresSymbol(lexer) || lexer.peek().kind == TokenKind::Epsilon) {
+                        lexer.fail(lexer.peek(), "%prec has to end an alternative");
+                    }
+                    break;
+                } else if (token.kind == TokenKind::Epsilon) {
+                    if (epsilon || symbols.size() != production.begin) {
+                        lexer.fail(token, "ε has to be the only symbol of an alternative");
+                    }
+                    epsilon = true;
+                    lexer.next();
+                } else {
+                    break;
+                }
+            }
+            production.end = symbols.size();
+            if (!epsilon && production.begin == production.end) {
+                lexer.fail(lexer.peek(), "empty alternative, write ε for the empty string");
+            }
+            rawProductions.push_back(production);
+            if (lexer.peek().kind == TokenKind::Define) {
+                lexer.fail(lexer.peek(), "expected a rule name before ::=");
+            }
+            if (lexer.peek().kind != TokenKind::Bar) {
+                break;
+            }
+            lexer.next();
+        }
+    }
+    if (rawProductions.empty()) {
+        throw GrammarError{source, 1, 1, "the grammar has no rules"};
+    }
+
+    GrammarFile result{};
+    vector<Item> noTerminalItems{};
+    noTerminalItems.reserve(ruleNames.size());
+    for (auto name : ruleNames) {
+        noTerminalItems.emplace_back(string{name}, ItemType::NoTerminal);
+    }
+    vector<Item> terminalItems{};
+    unordered_map<string_view, int> terminalIndex{};
+    auto terminalOf = [&](const RawSymbol &symbol) -> const Item & {
+        auto terminal = terminalIndex.emplace(symbol.name, static_cast<int>(terminalItems.size()));
+        if (terminal.second) {
+            terminalItems.emplace_back(string{symbol.name}, ItemType::Terminal);
+        }
+        return terminalItems[terminal.first->second];
+    };
+    // the terminal of a precedence declaration
+    auto declaredTerminal = [&](const RawSymbol &symbol) -> const Item & {
+        if (!symbol.quoted && ruleIndex.count(symbol.name) != 0) {
+            throw GrammarError{source, symbol.location.line, symbol.location.column,
+                               "precedence of the no terminal " + string{symbol.name}};
+        }
+        return terminalOf(symbol);
+    };
+    vector<Item> handle{};
+    result.productionList.reserve(rawProductions.size() + 1);
+    result.locations.reserve(rawProductions.size() + 1);
+    bool startUsed = false;
+    for (auto &raw : rawProductions) {
+        handle.clear();
+        if (raw.begin == raw.end) {
+            handle.push_back(EMPTY);
+        }
+        for (auto i = raw.begin; i < raw.end; i++) {
+            auto &symbol = symbols[i];
+            auto rule = symbol.quoted ? ruleIndex.end() : ruleIndex.find(symbol.name);
+            if (rule != ruleIndex.end()) {
+                startUsed = startUsed || rule->second == 0;
+                handle.push_back(noTerminalItems[rule->second]);
+                continue;
+            }
+            handle.push_back(terminalOf(symbol));
+        }
+        result.productionList.emplace_back(noTerminalItems[raw.rule], handle);
+        result.locations.push_back(raw.location);
+    }
+    result.noTerminals = noTerminalItems.size();
+    result.terminals = terminalItems.size();
+    for (auto &level : rawLevels) {
+        vector<Item> terminals{};
+        for (auto &symbol : level.terminals) {
+            terminals.push_back(declaredTerminal(symbol));
+        }
+        result.precedenceLevels.emplace_back(level.associativity, std::move(terminals));
+    }
+    for (size_t p = 0; p < rawProductions.size(); p++) {
+        auto &symbol = rawProductions[p].precedence;
+        if (!symbol.name.empty()) {
+            result.productionPrecedence.emplace_back(p, declaredTerminal(symbol));
+        }
+    }
+
+    // the start production has to be the only production of a no terminal that no other production uses
+    auto &first = rawProductions.front();
+    bool startShape = !startUsed && first.end - first.begin == 1 && !symbols[first.begin].quoted &&
+                     ruleIndex.count(symbols[first.begin].name) != 0 &&
+                     (rawProductions.size() == 1 || rawProductions[1].rule != 0);
+    for (size_t i = 2; startShape && i < rawProductions.size(); i++) {
+        startShape = rawProductions[i].rule != 0;
+    }
+    if (!startShape) {
+        string startName = string{ruleNames.front()} + "_";
+        while (ruleIndex.count(startName) != 0) {
+            startName += "_";
+        }
+        result.productionList.insert(result.productionList.begin(),
+                                     Production{Item{startName, ItemType::NoTerminal},
+                                                vector<Item>{noTerminalItems.front()}});
+        result.locations.insert(result.locations.begin(), first.location);
+        result.noTerminals++;
+        for (auto &precedence : result.productionPrecedence) {
+            precedence.first++;
+        }
+    }
+    return result;
+}
+
+Context GrammarFile::context() const {
+    Context result{productionList, productionList.front()};
+    for (auto &level : precedenceLevels) {
+        result.declarePrecedence(level.first, level.second);
+    }
+    for (auto &precedence : productionPrecedence) {
+        result.setPrecedence(productionList[precedence.first], precedence.second);
+    }
+    return result;
+}
+
+GrammarFile GrammarFile::load(const string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw runtime_error("can not open grammar file " + path);
+    }
+    struct stat status{};
+    if (::fstat(fd, &status) == -1) {
+        ::close(fd);
+        throw runtime_error("can not read grammar file " + path);
+    }
+    auto length = static_cast<size_t>(status.st_size);
+    if (length == 0) {
+        ::close(fd);
+        return parse(nullptr, nullptr, path);
+    }
+    void *mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw runtime_error("can not map grammar file " + path);
+    }
+    ::madvise(mapped, length, MADV_SEQUENTIAL);
+    auto text = static_cast<const char *>(mapped);
+    try {
+        auto result = parse(text, text + length, path);
+        ::munmap(mapped, length);
+        return result;
+    } catch (...) {
+        ::munmap(mapped, length);
+        throw;
+    }
+}
@@ -0,0 +1,90 @@
+#ifndef GRAMMAR_FILE_H
+#define GRAMMAR_FILE_H
+
+#include "Context.h"
+#include <stdexcept>
+#include <string>
+
+// a syntax error of a grammar file, what() is "source:line:column: message"
+class GrammarError : public std::runtime_error {
+public:
+    GrammarError(const std::string &source, size_t lineNumber, size_t columnNumber, const std::string &message);
+
+    size_t line() const {
+        return lineNumber;
+    }
+
+    size_t column() const {
+        return columnNumber;
+    }
+
+private:
+    size_t lineNumber;
+    size_t columnNumber;
+};
+
+// a grammar in the bnf notation of test/lua/README.md:
+//   stat ::= do block end | while exp do block end
+//   optbreak ::= ε | `;´
+// a rule runs until the next `name ::=`, the names defined by a rule are no terminals and every other
+// symbol is a terminal. quoted symbols (`x´, `x`, 'x' or "x") are always terminals, ε is the empty
+// alternative and // comments out the rest of the line.
+// the first rule is the start rule, unless it already has the shape `S_ ::= S` a start production
+// `<name>_ ::= <name>` is put in front of it.
+// %left, %right and %nonassoc followed by terminals declare a precedence level like in yacc, each binding
+// tighter than the ones before, and `%prec x` at the end of an alternative gives it the level of x.
+class GrammarFile {
+public:
+    struct Location {
+        size_t line;
+        size_t column;
+    };
+
+    // maps the file and parses it in one pass, throws GrammarError on syntax errors
+    // and std::runtime_error if the file can not be read
+    static GrammarFile load(const std::string &path);
+
+    // source only names the text in errors
+    static GrammarFile parse(const char *begin, const char *end, const std::string &source);
+
+    static GrammarFile parse(const std::string &text, const std::string &source = "<string>") {
+        return parse(text.data(), text.data() + text.size(), source);
+    }
+
+    const std::vector<Production> &productions() const {
+        return productionList;
+    }
+
+    const Production &startProduction() const {
+        return productionList.front();
+    }
+
+    // where the alternative of production starts, an added start production points at the first rule
+    const Location &location(size_t production) const {
+        return locations[production];
+    }
+
+    size_t noTerminalCount() const {
+        return noTerminals;
+    }
+
+    size_t terminalCount() const {
+        return terminals;
+    }
+
+    // a Context of the productions with the precedence levels declared
+    Context context() const;
+
+private:
+    GrammarFile() = default;
+
+    std::vector<Production> productionList;
+    std::vector<Location> locations;
+    std::vector<std::pair<Associativity, std::vector<Item>>> precedenceLevels;
+    // (production, terminal) of every %prec
+    std::vector<std::pair<size_t, Item>> productionPrecedence;
+    size_t noTerminals = 0;
+    size_t terminals = 0;
+};
+
+#endif
@@ -3,146 +3,112 @@
 //
 
 #include "Handler.h"
+#include "InternPool.h"
 #include <iostream>
 #include <utility>
 
 using std::optional;
-using std::move;
 using std::vector;
 using std::next;
-using std::exception;
 using std::set;
 using std::cout;
 using std::endl;
-using std::distance;
-using std::equal;
 using std::lexicographical_compare;
 using std::runtime_error;
 
-Handler::Handler(Production p, size_t pos) : production{move(p)}, position{pos},
-                                             lookForward{} {
+Handler::Handler(const Production &p, size_t pos) : Handler{p, pos, LookForward::none()} {
 
 }
 
-Handler::Handler(Production p, size_t pos, std::set<Item> lookTable) :
-        production{move(p)},
-        position{pos},
-        lookForward(std::move(lookTable)) {
+Handler::Handler(const Production &p, size_t pos, const std::set<Item> &lookTable) :
+        Handler{p, pos, LookForward::intern(lookTable)} {
 
 }
 
-vector<Item> Handler::alpha() {
+Handler::Handler(const Production &p, size_t pos, const LookForward &look) :
+        Handler{&look.pool().productions().intern(p), static_cast<int>(pos), &look} {
+
+}
+
+vector<Item> Handler::alpha() const {
     if (isEnd()) {
         return vector<Item>{};
     }
-    return vector<Item>{production.handleList.begin(), B()};
+    return vector<Item>{production->begin(), B()};
 }
 
-auto Handler::B() -> decltype(production.handleList.begin()) {
-    return ::next(production.handleList.begin(), position);
+vector<Item>::const_iterator Handler::B() const {
+    return ::next(production->begin(), position);
 }
 
-optional<Item> Handler::bet() {
-    if (position >= production.size() - 1) {
+optional<Item> Handler::bet() const {
+    if (position >= static_cast<int>(production->size()) - 1) {
         return optional<Item>{};
     }
-    return optional<Item>{production.handleList[position + 1]};
+    return optional<Item>{(*production)[position + 1]};
 }
 
-optional<vector<Item>> Handler::left() {
-    if (position >= production.size() - 1) {
+optional<vector<Item>> Handler::left() const {
+    if (position >= static_cast<int>(production->size()) - 1) {
         return optional<vector<Item>>{};
     }
-    auto start = production.handleList.begin();
-    std::advance(start, position + 1);
-    return optional<vector<Item>>{vector<Item>{start, production.handleList.end()}};
+    return optional<vector<Item>>{vector<Item>{::next(production->begin(), position + 1), production->end()}};
 }
 
-bool Handler::isEnd() {
-    return position >= production.size();
-}
-
-Handler Handler::nextHandler() {
+Handler Handler::nextHandler() const {
     if (isEnd()) {
         throw std::runtime_error("at production end without nextHandler");
     }
     return Handler{production, position + 1, lookForward};
 }
 
-set<Item> &Handler::getLookForward() {
-    return lookForward;
-}
-
-Item Handler::current() {
-    if (position > production.size() - 1) {
+Item Handler::current() const {
+    if (position > static_cast<int>(production->size()) - 1) {
         throw runtime_error("invalid index");
     }
-    return production[position];
+    return (*production)[position];
 }
 
 void Handler::addLookForward(std::set<Item>::const_iterator begin, std::set<Item>::const_iterator end) {
-    lookForward.insert(begin, end);
-}
-
-Item Handler::getItem() {
-    return production.getItem();
+    addLookForward(LookForward::intern(set<Item>{begin, end}));
 }
 
 bool Handler::operator<(const Handler &handler) const {
-    if (production.getName() != handler.production.getName()) {
-        return production.getName() < handler.production.getName();
-    } else {
-        auto comparator = [](const Item &a1, const Item &a2) { return a1 < a2; };
-        auto result = lexicographical_compare(production.handleList.begin(), production.handleList.end(),
-                                              handler.production.handleList.begin(),
-                                              handler.production.handleList.end(),
-                                              comparator);
-        if (result != 0) {
-            return result;
-        }
-        return position < handler.position;
+    if (production->getItem() != handler.production->getItem()) {
+        return production->getItem() < handler.production->getItem();
+    }
+    if (production != handler.production) {
+        return lexicographical_compare(production->begin(), production->end(), handler.production->begin(),
+                                       handler.production->end());
     }
+    return position < handler.position;
 }
 
-bool Handler::operator==(const Handler &handler) const {
-    if (production.handleList.size() != handler.production.handleList.size()) {
-        return false;
-    }
-    if (lookForward.size() != handler.lookForward.size()) {
-        return false;
-    }
-    auto match = equal(production.handleList.begin(), production.handleList.begin(),
-                       handler.production.handleList.begin());
-    auto lookMatch = equal(lookForward.begin(), lookForward.end(), handler.lookForward.begin());
-    return match && lookMatch && production == handler.production && handler.position == position;
+static size_t mix(size_t seed, size_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+size_t Handler::hash() const {
+    // productions and look forward sets are interned, their addresses identify them
+    size_t result = mix(reinterpret_cast<size_t>(production), static_cast<size_t>(position));
+    return mix(result, lookForward->hash());
 }
 
-void Handler::printHandler() {
-    cout << production.getName() << " -> ";
-    for (int i = 0; i < production.handleList.size(); i++) {
-        auto &t = production.handleList[i];
+void Handler::printHandler() const {
+    cout << production->getName() << " -> ";
+    for (int i = 0; i < static_cast<int>(production->size()); i++) {
+        auto &t = (*production)[i];
         if (position == i) {
             cout << "·";
         }
         cout << t.getName();
     }
-    if (position == production.handleList.size()) {
+    if (position == static_cast<int>(production->size())) {
         cout << "·";
     }
     cout << ",< ";
-    for (auto &i : lookForward) {
+    for (auto &i : *lookForward) {
         cout << i.getName() << " ";
     }
     cout << ">" << endl;
 }
-
-Production &Handler::getProduction() {
-    return production;
-}
-
-int Handler::getPosition() {
-    return position;
-}
-
-
-
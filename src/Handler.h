@@ -7,53 +7,94 @@
 
 #include "Common.h"
 #include "Production.h"
+#include "ProductionTable.h"
+#include "LookForward.h"
 #include <exception>
 #include <optional>
 
+// a lr(1) item: a pointer into the shared ProductionTable, the position of the dot and an interned look forward
+// set, so copying or advancing a handler copies three words and allocates nothing. both live in an InternPool,
+// a handler is valid as long as a Context or a state holding that pool is alive.
+// the constructors intern into InternPool::current(), the one taking look into the pool of look.
 class Handler {
 private:
-    Production production;
-    std::set<Item> lookForward;
-    size_t position;
+    const Production *production;
+    const LookForward *lookForward;
+    int position;
+
+    Handler(const Production *shared, int pos, const LookForward *look) : production{shared},
+                                                                          lookForward{look},
+                                                                          position{pos} {
+    }
 
 public:
-    explicit Handler(Production p, size_t position = 0);
+    explicit Handler(const Production &p, size_t position = 0);
+
+    Handler(const Production &p, size_t pos, const std::set<Item> &lookTable);
+
+    Handler(const Production &p, size_t pos, const LookForward &look);
 
-    Handler(Production p, size_t pos, std::set<Item> lookTable);
+    // p has to be a production of the pool of look, it is not interned again
+    static Handler shared(const Production &p, size_t pos, const LookForward &look) {
+        return Handler{&p, static_cast<int>(pos), &look};
+    }
 
-    std::vector<Item> alpha();
+    std::vector<Item> alpha() const;
 
-    Item last() {
-        return production.last();
+    Item last() const {
+        return production->last();
     }
 
-    auto B() -> decltype(production.handleList.begin());
+    std::vector<Item>::const_iterator B() const;
 
-    std::optional<Item> bet();
+    std::optional<Item> bet() const;
 
-    std::optional<std::vector<Item>> left();
+    std::optional<std::vector<Item>> left() const;
 
-    void printHandler();
+    void printHandler() const;
 
-    bool isEnd();
+    bool isEnd() const {
+        return position >= static_cast<int>(production->size());
+    }
 
-    Handler nextHandler();
+    Handler nextHandler() const;
 
     bool operator<(const Handler &handler) const;
 
-    bool operator==(const Handler &handler) const;
+    bool operator==(const Handler &handler) const {
+        return production == handler.production && position == handler.position &&
+               lookForward == handler.lookForward;
+    }
+
+    size_t hash() const;
+
+    bool isKernel() const {
+        return position > 0;
+    }
 
     void addLookForward(std::set<Item>::const_iterator begin, std::set<Item>::const_iterator end);
 
-    Item current();
+    void addLookForward(const LookForward &look) {
+        lookForward = &lookForward->merge(look);
+    }
+
+    Item current() const;
 
-    std::set<Item> &getLookForward();
+    const LookForward &getLookForward() const {
+        return *lookForward;
+    }
 
-    Item getItem();
+    Item getItem() const {
+        return production->getItem();
+    }
 
-    Production &getProduction();
+    const Production &getProduction() const {
+        return *production;
+    }
 
-    int getPosition();
+    int getPosition() const {
+        return position;
+    }
 };
 
 
@@ -3,8 +3,10 @@
 //
 
 #include "HandlerSet.h"
+#include "InternPool.h"
 
 #include <utility>
+#include <algorithm>
 
 using std::set;
 using std::move;
@@ -12,15 +14,18 @@ using std::equal;
 using std::lexicographical_compare;
 using std::vector;
 
-HandlerSet::HandlerSet(Item item) : shift{move(item)}, handlerList{}, id{} {
+HandlerSet::HandlerSet(Item item) : shift{move(item)}, handlerList{}, pool{}, id{}, transitions{} {
 
 }
 
-HandlerSet::HandlerSet(Item item, vector<Handler> handlers) : shift{move(item)}, handlerList{move(handlers)}, id{} {
-
+HandlerSet::HandlerSet(Item item, vector<Handler> handlers) : shift{move(item)}, handlerList{move(handlers)}, pool{},
+                                                             id{}, transitions{} {
+    if (!handlerList.empty()) {
+        pool = handlerList.front().getLookForward().pool().shared_from_this();
+    }
 }
 
-const Item &HandlerSet::shiftItem() {
+const Item &HandlerSet::shiftItem() const {
     return shift;
 }
 
@@ -42,6 +47,55 @@ bool HandlerSet::operator==(const HandlerSet &other) const {
     return shift == other.shift && equal(handlerList.begin(), handlerList.end(), other.handlerList.begin());
 }
 
+template<typename Function>
+static void forKernel(const vector<Handler> &handlerList, Function function) {
+    bool hasKernel = std::any_of(handlerList.begin(), handlerList.end(),
+                                 [](const Handler &handler) { return handler.isKernel(); });
+    for (auto &handler : handlerList) {
+        if (handler.isKernel() || !hasKernel) {
+            function(handler);
+        }
+    }
+}
+
+size_t HandlerSet::kernelHash() const {
+    // the sum keeps the hash independent from the order the kernel handlers were generated in
+    size_t result = 0;
+    forKernel(handlerList, [&result](const Handler &handler) {
+        result += handler.hash() * 0x9e3779b97f4a7c15ull + 1;
+    });
+    return result;
+}
+
+bool HandlerSet::sameKernel(const HandlerSet &other) const {
+    // the kernels are a few handlers, comparing them pairwise is cheaper than collecting them
+    auto hasKernel = [](const vector<Handler> &handlers) {
+        return std::any_of(handlers.begin(), handlers.end(), [](const Handler &handler) { return handler.isKernel(); });
+    };
+    bool kernel = hasKernel(handlerList);
+    bool otherKernel = hasKernel(other.handlerList);
+    auto inKernel = [](const Handler &handler, bool hasKernel) { return handler.isKernel() || !hasKernel; };
+    size_t count = 0;
+    for (auto &handler : handlerList) {
+        count += inKernel(handler, kernel);
+    }
+    for (auto &handler : other.handlerList) {
+        count -= inKernel(handler, otherKernel);
+    }
+    if (count != 0) {
+        return false;
+    }
+    for (auto &handler : handlerList) {
+        if (inKernel(handler, kernel) &&
+            std::none_of(other.handlerList.begin(), other.handlerList.end(), [&](const Handler &candidate) {
+                return inKernel(candidate, otherKernel) && candidate == handler;
+            })) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void HandlerSet::setId(int pid) {
     this->id = pid;
 }
@@ -50,10 +104,23 @@ void HandlerSet::setParentId(int parentId) {
     this->parent = parentId;
 }
 
-int HandlerSet::getId() {
+int HandlerSet::getId() const {
     return id;
 }
 
-int HandlerSet::getParentId() {
+int HandlerSet::getParentId() const {
     return parent;
 }
+
+void HandlerSet::addTransition(const Item &item, int target) {
+    transitions.emplace_back(item.getId(), target);
+}
+
+int HandlerSet::transition(const Item &item) const {
+    for (auto &t : transitions) {
+        if (t.first == item.getId()) {
+            return t.second;
+        }
+    }
+    return -1;
+}
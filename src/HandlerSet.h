@@ -7,6 +7,7 @@
 
 #include "Handler.h"
 #include "Common.h"
+#include <memory>
 
 class HandlerSet {
 public:
@@ -14,27 +15,53 @@ public:
 
     HandlerSet(Item item, std::vector<Handler> handlerList);
 
-    const Item &shiftItem();
+    const Item &shiftItem() const;
 
     std::vector<Handler> &ruleList();
 
+    const std::vector<Handler> &ruleList() const {
+        return handlerList;
+    }
+
     bool operator<(const HandlerSet &other) const;
 
     bool operator==(const HandlerSet &other) const;
 
+    // the kernel are the handlers whose position is behind the first item, they identify a lr(1) state.
+    // only the start state has no such handler, its kernel is the whole set.
+    size_t kernelHash() const;
+
+    bool sameKernel(const HandlerSet &other) const;
+
     void setId(int pid);
 
     void setParentId(int parentId);
 
-    int getId();
+    int getId() const;
+
+    int getParentId() const;
+
+    void addTransition(const Item &item, int target);
+
+    void reserveTransitions(size_t count) {
+        transitions.reserve(count);
+    }
+
+    // the state reached by shifting item, -1 if there is no such transition
+    int transition(const Item &item) const;
 
-    int getParentId();
+    const std::vector<std::pair<int, int>> &transitionList() const {
+        return transitions;
+    }
 
 private:
     Item shift;
     std::vector<Handler> handlerList;
+    // the handlers point into it, it stays alive as long as the state does
+    std::shared_ptr<InternPool> pool;
     int id = -1;
     int parent = -1;
+    std::vector<std::pair<int, int>> transitions;
 };
 
 
@@ -0,0 +1,87 @@
+#include "Statistics.h"
+#include <cstdlib>
+#include <new>
+#include <malloc.h>
+
+// replaces the global operator new and delete of the program it is linked into with ones counting for Statistics
+
+namespace {
+
+void *allocate(size_t size) {
+    void *pointer = ::malloc(size == 0 ? 1 : size);
+    if (pointer != nullptr) {
+        Statistics::heapAllocated(::malloc_usable_size(pointer));
+    }
+    return pointer;
+}
+
+void release(void *pointer) {
+    if (pointer == nullptr) {
+        return;
+    }
+    Statistics::heapReleased(::malloc_usable_size(pointer));
+    ::free(pointer);
+}
+
+const bool enabled = (Statistics::enableHeapCounting(), true);
+
+}
+
+void *operator new(size_t size) {
+    while (true) {
+        void *pointer = allocate(size);
+        if (pointer != nullptr) {
+            return pointer;
+        }
+        // the new handler may free some memory for another try
+        auto handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc{};
+        }
+        handler();
+    }
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return operator new(size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    try {
+        return operator new[](size);
+    } catch (...) {
+        return nullptr;
+    }
+}
+
+void operator delete(void *pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    release(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+    release(pointer);
+}
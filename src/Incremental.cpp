@@ -0,0 +1,178 @@
+#include "Incremental.h"
+#include <algorithm>
+#include <unordered_set>
+
+extern const Item EMPTY;
+extern const Item Eof;
+
+using std::vector;
+using std::set;
+using std::unordered_set;
+using std::move;
+
+IncrementalLr1::IncrementalLr1(Context grammar) : current{std::make_unique<Context>(move(grammar))}, stateSet{} {
+    stateSet = current->generalLr1();
+}
+
+vector<char> IncrementalLr1::cleanStates(Context &next, Update &update) {
+    auto &productions = ProductionTable::global();
+    unordered_set<const Production *> before{};
+    unordered_set<const Production *> after{};
+    for (auto &p : current->getRules()) {
+        before.insert(&productions.intern(p));
+    }
+    for (auto &p : next.getRules()) {
+        after.insert(&productions.intern(p));
+    }
+    set<Item> changedRules{};
+    for (auto p : before) {
+        if (after.count(p) == 0) {
+            update.removedProductions++;
+            changedRules.insert(p->getItem());
+        }
+    }
+    for (auto p : after) {
+        if (before.count(p) == 0) {
+            update.addedProductions++;
+            changedRules.insert(p->getItem());
+        }
+    }
+
+    // FIRST is recomputed as a whole, it is a fixpoint over bit sets and cheap next to the closures
+    set<int> noTerminals{current->getGrammar().noTerminals().begin(), current->getGrammar().noTerminals().end()};
+    noTerminals.insert(next.getGrammar().noTerminals().begin(), next.getGrammar().noTerminals().end());
+    set<Item> changedFirst{};
+    for (auto id : noTerminals) {
+        Item item{id};
+        bool known = current->firstExist(item);
+        if (known != next.firstExist(item) || (known && current->firstAt(item)->second != next.firstAt(item)->second)) {
+            changedFirst.insert(item);
+        }
+    }
+    update.changedRules.assign(changedRules.begin(), changedRules.end());
+    update.changedFirst.assign(changedFirst.begin(), changedFirst.end());
+
+    // closing A -> α·Bβ, L reads the productions of B and FIRST(β); a state none of whose items reads a change
+    // closes to the same items, the items it adds read nothing else
+    auto readsChange = [&](const Handler &handler) {
+        if (handler.isEnd() || !handler.B()->isNoTerminal()) {
+            return false;
+        }
+        if (changedRules.count(*handler.B()) != 0) {
+            return true;
+        }
+        for (auto i = std::next(handler.B()); i != handler.getProduction().end(); ++i) {
+            if (changedFirst.count(*i) != 0) {
+                return true;
+            }
+            if (!next.isNullable(*i)) {
+                return false;
+            }
+        }
+        return false;
+    };
+    vector<char> clean(stateSet.size(), 1);
+    for (size_t i = 0; i < stateSet.size(); i++) {
+        auto &handlers = stateSet[i].ruleList();
+        clean[i] = std::none_of(handlers.begin(), handlers.end(), readsChange);
+    }
+    return clean;
+}
+
+IncrementalLr1::Update IncrementalLr1::update(Context grammar) {
+    auto next = std::make_unique<Context>(move(grammar));
+    next->first();
+    Update result{};
+    auto clean = cleanStates(*next, result);
+    auto &previous = stateSet;
+
+    // the same breadth first walk as generalLr1(), a state whose kernel an unchanged state of the previous
+    // automaton has takes over its handlers instead of being closed
+    vector<HandlerSet> states{};
+    states.reserve(previous.size());
+    // the previous state every new state was taken over from, -1 if it was closed
+    vector<int> origin{};
+    origin.reserve(previous.size());
+    StateIndex index{states};
+    StateIndex previousIndex{previous};
+    auto &productions = ProductionTable::global();
+    if (&productions.intern(current->getStart()) == &productions.intern(next->getStart()) && clean[0]) {
+        states.emplace_back(Eof, previous[0].ruleList());
+        origin.push_back(0);
+        result.reusedStates++;
+    } else {
+        vector<Handler> handlers{};
+        next->closureSet(Handler{next->getStart(), 0, set<Item>{Eof}}, handlers);
+        states.emplace_back(Eof, move(handlers));
+        origin.push_back(-1);
+        result.closedStates++;
+    }
+    states[0].setId(0);
+    index.insert(states[0], 0);
+
+    // kernel identifies the successor over symbol, it is either a previous state or the unclosed kernel
+    auto visit = [&](int frontier, const Item &symbol, const HandlerSet &kernel) {
+        int id = index.find(kernel);
+        if (id == -1) {
+            id = static_cast<int>(states.size());
+            int old = previousIndex.find(kernel);
+            if (old != -1 && clean[old]) {
+                states.emplace_back(symbol, previous[old].ruleList());
+                result.reusedStates++;
+            } else {
+                vector<Handler> handlers{};
+                for (auto &handler : kernel.ruleList()) {
+                    if (handler.isKernel()) {
+                        handlers.push_back(handler);
+                    }
+                }
+                states.emplace_back(symbol, next->closureItemSet(handlers));
+                old = -1;
+                result.closedStates++;
+            }
+            origin.push_back(old);
+            states.back().setId(id);
+            states.back().setParentId(frontier);
+            index.insert(states.back(), id);
+        }
+        states[frontier].addTransition(symbol, id);
+    };
+
+    vector<Item> symbols{};
+    for (size_t frontier = 0; frontier < states.size(); frontier++) {
+        int state = static_cast<int>(frontier);
+        if (origin[frontier] != -1) {
+            // the items are the previous ones, so are the successor kernels
+            auto &transitions = previous[origin[frontier]].transitionList();
+            states[frontier].reserveTransitions(transitions.size());
+            for (auto &transition : transitions) {
+                visit(state, Item{transition.first}, previous[transition.second]);
+            }
+            continue;
+        }
+        // the successors in the order of Context::Goto(), no terminals first and both kinds by symbol id
+        symbols.clear();
+        for (auto &handler : states[frontier].ruleList()) {
+            if (!handler.isEnd() && handler.current() != EMPTY) {
+                symbols.push_back(handler.current());
+            }
+        }
+        std::sort(symbols.begin(), symbols.end(), [](const Item &a1, const Item &a2) {
+            return a1.isNoTerminal() != a2.isNoTerminal() ? a1.isNoTerminal() : a1 < a2;
+        });
+        symbols.erase(std::unique(symbols.begin(), symbols.end()), symbols.end());
+        states[frontier].reserveTransitions(symbols.size());
+        for (auto &symbol : symbols) {
+            vector<Handler> kernel{};
+            for (auto &handler : states[frontier].ruleList()) {
+                if (!handler.isEnd() && handler.current() == symbol) {
+                    kernel.push_back(handler.nextHandler());
+                }
+            }
+            visit(state, symbol, HandlerSet{symbol, move(kernel)});
+        }
+    }
+    current = move(next);
+    stateSet = move(states);
+    return result;
+}
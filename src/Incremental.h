@@ -0,0 +1,50 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "Context.h"
+#include <memory>
+
+// keeps the lr(1) automaton of a grammar across edits of its rules. update() diffs the rules of the new grammar
+// against the current ones and closes again only the states whose closure reads a changed rule or a changed FIRST
+// set, every other state is taken over from the previous automaton with its handlers.
+// the states equal the ones generalLr1() builds for the new grammar, in the same numbering.
+class IncrementalLr1 {
+public:
+    struct Update {
+        size_t addedProductions = 0;
+        size_t removedProductions = 0;
+        // the no terminals whose productions changed and the ones whose FIRST set or nullability changed
+        std::vector<Item> changedRules;
+        std::vector<Item> changedFirst;
+        // the states taken over from the previous automaton and the ones closed again
+        size_t reusedStates = 0;
+        size_t closedStates = 0;
+    };
+
+    explicit IncrementalLr1(Context grammar);
+
+    // replaces the grammar by the edited one, its precedence declarations are kept with it
+    Update update(Context grammar);
+
+    Context &context() {
+        return *current;
+    }
+
+    const std::vector<HandlerSet> &states() const {
+        return stateSet;
+    }
+
+    // the table of the current states. it is filled again as a whole, which is linear in the states
+    ParseTable table(size_t threads = 1) {
+        return current->table(stateSet, threads);
+    }
+
+private:
+    // whether the closure of every state of the current automaton is the same under next
+    std::vector<char> cleanStates(Context &next, Update &update);
+
+    std::unique_ptr<Context> current;
+    std::vector<HandlerSet> stateSet;
+};
+
+#endif
@@ -0,0 +1,57 @@
+#include "InternPool.h"
+#include <algorithm>
+#include <new>
+
+using std::lock_guard;
+using std::mutex;
+using std::shared_ptr;
+using std::weak_ptr;
+
+namespace {
+
+mutex liveMutex;
+weak_ptr<InternPool> live{};
+
+}
+
+shared_ptr<InternPool> InternPool::acquire() {
+    lock_guard<mutex> lock{liveMutex};
+    auto pool = live.lock();
+    if (!pool) {
+        pool = std::make_shared<InternPool>();
+        live = pool;
+    }
+    return pool;
+}
+
+InternPool &InternPool::current() {
+    static auto program = std::make_shared<InternPool>();
+    lock_guard<mutex> lock{liveMutex};
+    auto pool = live.lock();
+    return pool ? *pool : *program;
+}
+
+const LookForward &InternPool::intern(const Item *first, const Item *last) {
+    size_t hash = 1469598103934665603ull;
+    for (auto p = first; p != last; p++) {
+        hash = (hash ^ static_cast<size_t>(p->getId())) * 1099511628211ull;
+    }
+    auto size = static_cast<size_t>(last - first);
+    lock_guard<mutex> lock{lookMutex};
+    auto &candidates = lookIndex[hash];
+    for (auto look : candidates) {
+        if (look->size() == size && std::equal(first, last, look->begin())) {
+            return *look;
+        }
+    }
+    auto items = arena.allocate<Item>(size);
+    std::uninitialized_copy(first, last, items);
+    auto look = new(arena.allocate<LookForward>(1)) LookForward{items, size, hash, this};
+    candidates.push_back(look);
+    return *look;
+}
+
+size_t InternPool::lookForwardBytes() const {
+    lock_guard<mutex> lock{lookMutex};
+    return arena.capacity();
+}
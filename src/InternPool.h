@@ -0,0 +1,53 @@
+#ifndef INTERN_POOL_H
+#define INTERN_POOL_H
+
+#include "Arena.h"
+#include "LookForward.h"
+#include "ProductionTable.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// the productions and look forward sets the handlers of one generation point at. a Context holds the pool from its
+// construction on and a state holds the pool of its handlers, the pool is released in bulk with the last of them.
+// while any of them is alive every Context shares its pool, so handlers of different contexts compare equal,
+// the next Context after that starts a new one. handlers built while no generation is alive go to a pool kept for
+// the whole program.
+class InternPool : public std::enable_shared_from_this<InternPool> {
+public:
+    // the pool of the live generations, a new one if there is none
+    static std::shared_ptr<InternPool> acquire();
+
+    // the pool of the live generations, or the one of the program if there is none. the pool of the live
+    // generations is only valid as long as one of them is
+    static InternPool &current();
+
+    InternPool() = default;
+
+    InternPool(const InternPool &) = delete;
+
+    InternPool &operator=(const InternPool &) = delete;
+
+    ProductionTable &productions() {
+        return productionTable;
+    }
+
+    // items sorted by id without duplicates
+    const LookForward &intern(const Item *first, const Item *last);
+
+    const LookForward &none() {
+        return intern(nullptr, nullptr);
+    }
+
+    // the bytes of the chunks holding the look forward sets
+    size_t lookForwardBytes() const;
+
+private:
+    ProductionTable productionTable;
+    mutable std::mutex lookMutex;
+    Arena arena;
+    std::unordered_map<size_t, std::vector<const LookForward *>> lookIndex;
+};
+
+#endif
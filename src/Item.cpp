@@ -2,12 +2,17 @@
 
 using std::string;
 
-Item::Item(string itemName, ItemType itemType)
-        : name{std::move(itemName)},
+Item::Item(const string &itemName, ItemType itemType)
+        : id{SymbolTable::global().intern(itemName, itemType)},
           type{itemType} {
 
 }
 
+Item::Item(int symbolId)
+        : id{symbolId},
+          type{SymbolTable::global().type(symbolId)} {
+
+}
 
 bool Item::isTerminal() const {
     return this->type == ItemType::Terminal;
@@ -17,10 +22,6 @@ bool Item::isNoTerminal() const {
     return !isTerminal();
 }
 
-bool Item::operator<(const Item &other) const {
-    return name < other.name;
-}
-
-bool Item::operator==(const Item &other) const {
-    return this->type == other.type && this->name == other.name;
+const string &Item::getName() const {
+    return SymbolTable::global().name(id);
 }
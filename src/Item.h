@@ -1,31 +1,39 @@
 #ifndef ITEM_H
 #define ITEM_H
 
-#include<string>
-
-enum class ItemType {
-    NoTerminal = 0,
-    Terminal = 1,
-};
+#include "SymbolTable.h"
+#include <string>
 
 class Item {
 public:
-    Item(std::string itemName, ItemType itemType);
+    Item(const std::string &itemName, ItemType itemType);
+
+    explicit Item(int symbolId);
+
+    bool operator==(const Item &other) const {
+        return id == other.id;
+    }
 
-    bool operator==(const Item &other) const;
+    bool operator!=(const Item &other) const {
+        return id != other.id;
+    }
 
     bool isNoTerminal() const;
 
     bool isTerminal() const;
 
-    bool operator<(const Item &other) const;
+    bool operator<(const Item &other) const {
+        return id < other.id;
+    }
+
+    const std::string &getName() const;
 
-    std::string getName() const {
-        return name;
+    int getId() const {
+        return id;
     }
 
 private:
-    std::string name;
+    int id;
     ItemType type;
 };
 
@@ -0,0 +1,234 @@
+#include "Lalr.h"
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <set>
+#include <stdexcept>
+
+using std::vector;
+using std::pair;
+using std::move;
+
+static long long transitionKey(int state, int symbol) {
+    return static_cast<long long>(state) << 32 | static_cast<unsigned int>(symbol);
+}
+
+LalrBuilder::LalrBuilder(const Grammar &grammarRef, const FirstFollow &setsRef, ClosureEngine &closureRef)
+        : grammar(grammarRef), sets(setsRef), closure(closureRef) {
+
+}
+
+void LalrBuilder::buildLr0() {
+    auto width = sets.terminalCount();
+    states.clear();
+    std::map<vector<int>, int> kernelIndex{};
+    int startRule = grammar.startProduction();
+    LrState startState{grammar.eof(), -1, vector<LrItem>{LrItem{startRule, 0, BitSet{width}}}, {}};
+    closure.close(startState.items);
+    kernelIndex.emplace(vector<int>{grammar.itemId(startRule, 0)}, 0);
+    states.push_back(move(startState));
+    for (size_t frontier = 0; frontier < states.size(); frontier++) {
+        // same order as Context::Goto, the no terminals first and both by symbol id
+        std::set<int> noTerminals{};
+        std::set<int> terminals{};
+        for (auto &item : states[frontier].items) {
+            auto &rhs = grammar.rhs(item.production);
+            if (item.position >= static_cast<int>(rhs.size()) || rhs[item.position] == grammar.epsilon()) {
+                continue;
+            }
+            int symbol = rhs[item.position];
+            (grammar.isTerminal(symbol) ? terminals : noTerminals).insert(symbol);
+        }
+        auto expand = [&](int symbol) {
+            vector<LrItem> kernel{};
+            vector<int> key{};
+            for (auto &item : states[frontier].items) {
+                auto &rhs = grammar.rhs(item.production);
+                if (item.position < static_cast<int>(rhs.size()) && rhs[item.position] == symbol) {
+                    kernel.push_back(LrItem{item.production, item.position + 1, BitSet{width}});
+                    key.push_back(grammar.itemId(item.production, item.position + 1));
+                }
+            }
+            std::sort(key.begin(), key.end());
+            int id;
+            auto found = kernelIndex.find(key);
+            if (found == kernelIndex.end()) {
+                id = static_cast<int>(states.size());
+                kernelIndex.emplace(move(key), id);
+                closure.close(kernel);
+                states.push_back(LrState{symbol, static_cast<int>(frontier), move(kernel), {}});
+            } else {
+                id = found->second;
+            }
+            states[frontier].transitions.emplace_back(symbol, id);
+        };
+        for (auto symbol : noTerminals) {
+            expand(symbol);
+        }
+        for (auto symbol : terminals) {
+            expand(symbol);
+        }
+    }
+    itemSlots.assign(states.size(), vector<pair<int, int>>{});
+    for (size_t s = 0; s < states.size(); s++) {
+        auto &items = states[s].items;
+        for (size_t slot = 0; slot < items.size(); slot++) {
+            itemSlots[s].emplace_back(grammar.itemId(items[slot].production, items[slot].position),
+                                      static_cast<int>(slot));
+        }
+        std::sort(itemSlots[s].begin(), itemSlots[s].end());
+    }
+}
+
+vector<LrState> LalrBuilder::build() {
+    buildLr0();
+    auto width = sets.terminalCount();
+    transitionList.clear();
+    transitionIndex.clear();
+    // transition 0 stands for the missing (0, S') of the augmented grammar, it only carries $
+    transitionList.push_back(Transition{0, grammar.startSymbol(), -1});
+    for (size_t s = 0; s < states.size(); s++) {
+        for (auto &next : states[s].transitions) {
+            if (!grammar.isTerminal(next.first)) {
+                transitionIndex.emplace(transitionKey(static_cast<int>(s), next.first),
+                                        static_cast<int>(transitionList.size()));
+                transitionList.push_back(Transition{static_cast<int>(s), next.first, next.second});
+            }
+        }
+    }
+    auto count = transitionList.size();
+    auto productionsOf = [this](size_t x) -> vector<int> {
+        if (x == 0) {
+            return vector<int>{grammar.startProduction()};
+        }
+        return grammar.productionsOf(transitionList[x].symbol);
+    };
+
+    // DR and reads
+    vector<BitSet> follow(count, BitSet{width});
+    vector<vector<int>> reads(count);
+    follow[0].set(grammar.terminalIndex(grammar.eof()));
+    for (size_t x = 1; x < count; x++) {
+        int target = transitionList[x].target;
+        for (auto &next : states[target].transitions) {
+            if (grammar.isTerminal(next.first)) {
+                follow[x].set(grammar.terminalIndex(next.first));
+            } else if (sets.nullable(next.first)) {
+                reads[x].push_back(transitionId(target, next.first));
+            }
+        }
+    }
+    digraph(reads, follow);
+
+    // (p, A) includes (p', B) for B -> βAγ, γ nullable and p' --β--> p
+    vector<vector<int>> includes(count);
+    for (size_t x = 0; x < count; x++) {
+        for (auto production : productionsOf(x)) {
+            auto &rhs = grammar.rhs(production);
+            walk(transitionList[x].state, production, [&](int state, size_t position) {
+                if (position < rhs.size() && !grammar.isTerminal(rhs[position]) &&
+                    nullableFrom(production, position + 1)) {
+                    includes[transitionId(state, rhs[position])].push_back(static_cast<int>(x));
+                }
+            });
+        }
+    }
+    digraph(includes, follow);
+
+    // lookback: every item on the path of (p, A) -> ω gets Follow(p, A), the reduce items included
+    for (size_t x = 0; x < count; x++) {
+        for (auto production : productionsOf(x)) {
+            walk(transitionList[x].state, production, [&](int state, size_t position) {
+                auto &slots = itemSlots[state];
+                int item = grammar.itemId(production, static_cast<int>(position));
+                auto found = std::lower_bound(slots.begin(), slots.end(), pair<int, int>{item, -1});
+                if (found != slots.end() && found->first == item) {
+                    states[state].items[found->second].lookForward.unionWith(follow[x]);
+                }
+            });
+        }
+    }
+    return move(states);
+}
+
+int LalrBuilder::transitionId(int state, int symbol) const {
+    auto found = transitionIndex.find(transitionKey(state, symbol));
+    if (found == transitionIndex.end()) {
+        throw std::runtime_error("unknown goto state");
+    }
+    return found->second;
+}
+
+int LalrBuilder::nextState(int state, int symbol) const {
+    for (auto &next : states[state].transitions) {
+        if (next.first == symbol) {
+            return next.second;
+        }
+    }
+    throw std::runtime_error("unknown goto state");
+}
+
+bool LalrBuilder::nullableFrom(int production, size_t position) const {
+    auto &rhs = grammar.rhs(production);
+    for (; position < rhs.size(); position++) {
+        int symbol = rhs[position];
+        if (symbol == grammar.epsilon()) {
+            continue;
+        }
+        if (grammar.isTerminal(symbol) || !sets.nullable(symbol)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename Visit>
+void LalrBuilder::walk(int from, int production, Visit &&visit) const {
+    auto &rhs = grammar.rhs(production);
+    int state = from;
+    for (size_t position = 0;; position++) {
+        visit(state, position);
+        if (position == rhs.size()) {
+            break;
+        }
+        // ε is not shifted, the item behind it stays in the same state
+        if (rhs[position] != grammar.epsilon()) {
+            state = nextState(state, rhs[position]);
+        }
+    }
+}
+
+void LalrBuilder::digraph(const vector<vector<int>> &relation, vector<BitSet> &result) {
+    depth.assign(relation.size(), 0);
+    stack.clear();
+    for (size_t x = 0; x < relation.size(); x++) {
+        if (depth[x] == 0) {
+            traverse(static_cast<int>(x), relation, result);
+        }
+    }
+}
+
+void LalrBuilder::traverse(int x, const vector<vector<int>> &relation, vector<BitSet> &result) {
+    stack.push_back(x);
+    int d = static_cast<int>(stack.size());
+    depth[x] = d;
+    for (auto y : relation[x]) {
+        if (depth[y] == 0) {
+            traverse(y, relation, result);
+        }
+        depth[x] = std::min(depth[x], depth[y]);
+        result[x].unionWith(result[y]);
+    }
+    if (depth[x] == d) {
+        // x is the root of a strongly connected component, all its members share one set
+        while (true) {
+            int top = stack.back();
+            stack.pop_back();
+            depth[top] = INT_MAX;
+            if (top == x) {
+                break;
+            }
+            result[top] = result[x];
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef LALR_H
+#define LALR_H
+
+#include "Grammar.h"
+#include "FirstFollow.h"
+#include "ClosureEngine.h"
+#include "LrItem.h"
+#include <unordered_map>
+
+// lalr(1) automaton: the lr(0) states with the look forward sets of DeRemer and Pennello.
+// every no terminal transition (p, A) gets
+//   Read(p, A)   = DR(p, A) plus Read of the transitions it reads through a nullable no terminal
+//   Follow(p, A) = Read(p, A) plus Follow of the transitions it includes
+// and an item gets the union of Follow(p, A) over the transitions it looks back to.
+class LalrBuilder {
+public:
+    LalrBuilder(const Grammar &grammar, const FirstFollow &sets, ClosureEngine &closure);
+
+    std::vector<LrState> build();
+
+    // the no terminal transitions of the last build, the start transition included
+    size_t transitionCount() const {
+        return transitionList.size();
+    }
+
+private:
+    struct Transition {
+        int state;
+        int symbol;
+        int target;
+    };
+
+    void buildLr0();
+
+    int transitionId(int state, int symbol) const;
+
+    int nextState(int state, int symbol) const;
+
+    bool nullableFrom(int production, size_t position) const;
+
+    // the DeRemer-Pennello digraph: closes sets over relation, one strongly connected component at a time
+    void digraph(const std::vector<std::vector<int>> &relation, std::vector<BitSet> &sets);
+
+    void traverse(int x, const std::vector<std::vector<int>> &relation, std::vector<BitSet> &sets);
+
+    // walks the production from the transition's state, calls visit(state, position) for every item on the path
+    template<typename Visit>
+    void walk(int from, int production, Visit &&visit) const;
+
+    const Grammar &grammar;
+    const FirstFollow &sets;
+    ClosureEngine &closure;
+    std::vector<LrState> states;
+    // (item id, slot) pairs of every state, sorted by item id
+    std::vector<std::vector<std::pair<int, int>>> itemSlots;
+    std::vector<Transition> transitionList;
+    std::unordered_map<long long, int> transitionIndex;
+    std::vector<int> depth;
+    std::vector<int> stack;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "Lexer.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// how many of the sixteen bytes at text, counted from the first, belong to the run class
+static unsigned runPrefix(const LexerTable::RunClass &run, const unsigned char *text) {
+#if defined(__SSE2__)
+    __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text));
+    __m128i hit = _mm_setzero_si128();
+    for (int i = 0; i < run.count; i++) {
+        auto low = _mm_set1_epi8(static_cast<char>(run.low[i]));
+        if (run.negated) {
+            hit = _mm_or_si128(hit, _mm_cmpeq_epi8(bytes, low));
+        } else {
+            // low <= byte <= high as unsigned bytes
+            auto high = _mm_set1_epi8(static_cast<char>(run.high[i]));
+            auto above = _mm_cmpeq_epi8(_mm_max_epu8(bytes, low), bytes);
+            auto below = _mm_cmpeq_epi8(_mm_min_epu8(bytes, high), bytes);
+            hit = _mm_or_si128(hit, _mm_and_si128(above, below));
+        }
+    }
+    auto mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+    unsigned stop = run.negated ? mask : ~mask & 0xffffu;
+    return stop == 0 ? 16 : static_cast<unsigned>(__builtin_ctz(stop));
+#else
+    for (unsigned i = 0; i < 16; i++) {
+        bool hit = false;
+        for (int r = 0; r < run.count; r++) {
+            hit = hit || (text[i] >= run.low[r] && text[i] <= run.high[r]);
+        }
+        if (hit == run.negated) {
+            return i;
+        }
+    }
+    return 16;
+#endif
+}
+
+LexResult Lexer::tokenize(const char *begin, const char *end, std::vector<int> &symbols,
+                          std::vector<LexToken> *tokens) const {
+    auto text = reinterpret_cast<const unsigned char *>(begin);
+    auto count = static_cast<size_t>(end - begin);
+    LexResult result{false, 0, 0};
+    size_t position = 0;
+    while (position < count) {
+        int state = 0;
+        int accepted = -1;
+        size_t acceptEnd = position;
+        size_t at = position;
+        while (at < count) {
+            int next = table.next(state, text[at]);
+            if (next == -1) {
+                break;
+            }
+            at++;
+            // the self loop was taken, the rest of the run stays in this state
+            if (next == state && vectorized && table.runClass(state).count != 0) {
+                auto &run = table.runClass(state);
+                while (count - at >= 16) {
+                    auto skipped = runPrefix(run, text + at);
+                    at += skipped;
+                    if (skipped != 16) {
+                        break;
+                    }
+                }
+            }
+            state = next;
+            if (table.accept(state) != -1) {
+                accepted = state;
+                acceptEnd = at;
+            }
+        }
+        if (accepted == -1) {
+            result.position = position;
+            return result;
+        }
+        if (!table.skip(accepted)) {
+            symbols.push_back(table.accept(accepted));
+            if (tokens != nullptr) {
+                tokens->push_back(LexToken{table.accept(accepted), position, acceptEnd});
+            }
+            result.tokens++;
+        }
+        position = acceptEnd;
+    }
+    result.complete = true;
+    result.position = count;
+    return result;
+}
@@ -0,0 +1,51 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include "LexerGenerator.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct LexToken {
+    int symbol;
+    // the byte range [begin, end) of the token
+    size_t begin;
+    size_t end;
+};
+
+struct LexResult {
+    bool complete;
+    // the byte no token matches at, the length of the text if the whole text was split into tokens
+    size_t position;
+    size_t tokens;
+};
+
+// splits text into tokens by longest match on a LexerTable.
+// runs of bytes keeping the dfa in the same state, like white space, the rest of a name or the
+// body of a string, are skipped sixteen bytes at a time with sse2 where it is available
+class Lexer {
+public:
+    explicit Lexer(const LexerTable &tableRef) : table(tableRef) {
+    }
+
+    // appends the symbol id of every token which is not a skip token, ready for LrParser::parse().
+    // tokens, if given, also gets the byte range of each of them
+    LexResult tokenize(const char *begin, const char *end, std::vector<int> &symbols,
+                       std::vector<LexToken> *tokens = nullptr) const;
+
+    LexResult tokenize(const std::string &text, std::vector<int> &symbols,
+                       std::vector<LexToken> *tokens = nullptr) const {
+        return tokenize(text.data(), text.data() + text.size(), symbols, tokens);
+    }
+
+    // turns the vectorized run skipping off, for comparing it with the byte by byte scan
+    void setVectorized(bool enabled) {
+        vectorized = enabled;
+    }
+
+private:
+    const LexerTable &table;
+    bool vectorized = true;
+};
+
+#endif
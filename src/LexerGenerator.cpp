@@ -0,0 +1,438 @@
+#include "LexerGenerator.h"
+#include "Item.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+using std::string;
+using std::vector;
+using std::map;
+using std::bitset;
+using std::runtime_error;
+
+// recursive descent over one pattern, appends the thompson fragments to the nfa
+class LexerGenerator::PatternParser {
+public:
+    struct Fragment {
+        int start;
+        int end;
+    };
+
+    PatternParser(vector<NfaState> &nfaRef, const TokenRule &ruleRef) : nfa(nfaRef), rule(ruleRef) {
+    }
+
+    Fragment parse() {
+        auto result = alternation();
+        if (position != rule.pattern.size()) {
+            fail(rule.pattern[position] == ')' ? "unbalanced )" : "unexpected character");
+        }
+        return result;
+    }
+
+private:
+    Fragment alternation() {
+        auto result = concatenation();
+        while (more() && peek() == '|') {
+            position++;
+            auto other = concatenation();
+            int start = state();
+            int end = state();
+            nfa[start].epsilon = {result.start, other.start};
+            nfa[result.end].epsilon.push_back(end);
+            nfa[other.end].epsilon.push_back(end);
+            result = Fragment{start, end};
+        }
+        return result;
+    }
+
+    Fragment concatenation() {
+        int start = state();
+        Fragment result{start, start};
+        while (more() && peek() != '|' && peek() != ')') {
+            auto next = repetition();
+            nfa[result.end].epsilon.push_back(next.start);
+            result.end = next.end;
+        }
+        return result;
+    }
+
+    Fragment repetition() {
+        auto result = atom();
+        while (more() && (peek() == '*' || peek() == '+' || peek() == '?')) {
+            char op = rule.pattern[position++];
+            int start = state();
+            int end = state();
+            nfa[start].epsilon.push_back(result.start);
+            nfa[result.end].epsilon.push_back(end);
+            if (op != '+') {
+                nfa[start].epsilon.push_back(end);
+            }
+            if (op != '?') {
+                nfa[result.end].epsilon.push_back(result.start);
+            }
+            result = Fragment{start, end};
+        }
+        return result;
+    }
+
+    Fragment atom() {
+        char c = rule.pattern[position++];
+        bitset<256> bytes{};
+        if (c == '(') {
+            auto result = alternation();
+            if (!more() || peek() != ')') {
+                fail("missing )");
+            }
+            position++;
+            return result;
+        } else if (c == '[') {
+            bytes = byteClass();
+        } else if (c == '.') {
+            bytes.set();
+            bytes.reset('\n');
+        } else if (c == '\\') {
+            bytes = escape();
+        } else if (c == '*' || c == '+' || c == '?' || c == ')') {
+            position--;
+            fail("nothing to repeat");
+        } else {
+            bytes.set(static_cast<unsigned char>(c));
+        }
+        int start = state();
+        int end = state();
+        nfa[start].bytes = bytes;
+        nfa[start].out = end;
+        return Fragment{start, end};
+    }
+
+    bitset<256> byteClass() {
+        bitset<256> result{};
+        bool negated = more() && peek() == '^';
+        position += negated;
+        bool first = true;
+        while (true) {
+            if (!more()) {
+                fail("missing ]");
+            }
+            char c = rule.pattern[position++];
+            if (c == ']' && !first) {
+                break;
+            }
+            first = false;
+            bitset<256> single{};
+            if (c == '\\') {
+                single = escape();
+            } else {
+                single.set(static_cast<unsigned char>(c));
+            }
+            // a range needs a single byte on both sides
+            if (single.count() == 1 && position + 1 < rule.pattern.size() && peek() == '-' &&
+                rule.pattern[position + 1] != ']') {
+                position++;
+                char last = rule.pattern[position++];
+                bitset<256> high{};
+                if (last == '\\') {
+                    high = escape();
+                } else {
+                    high.set(static_cast<unsigned char>(last));
+                }
+                int low = lowest(single);
+                if (high.count() != 1 || lowest(high) < low) {
+                    fail("invalid range");
+                }
+                for (int b = low; b <= lowest(high); b++) {
+                    single.set(b);
+                }
+            }
+            result |= single;
+        }
+        if (negated) {
+            result.flip();
+        }
+        return result;
+    }
+
+    bitset<256> escape() {
+        if (!more()) {
+            fail("trailing \\");
+        }
+        char c = rule.pattern[position++];
+        bitset<256> result{};
+        auto range = [&result](int low, int high) {
+            for (int b = low; b <= high; b++) {
+                result.set(b);
+            }
+        };
+        switch (c) {
+            case 'n':
+                result.set('\n');
+                break;
+            case 't':
+                result.set('\t');
+                break;
+            case 'r':
+                result.set('\r');
+                break;
+            case 'f':
+                result.set('\f');
+                break;
+            case 'v':
+                result.set('\v');
+                break;
+            case 'd':
+                range('0', '9');
+                break;
+            case 'w':
+                range('0', '9');
+                range('A', 'Z');
+                range('a', 'z');
+                result.set('_');
+                break;
+            case 's':
+                range('\t', '\r');
+                result.set(' ');
+                break;
+            case 'x': {
+                int value = 0;
+                for (int i = 0; i < 2; i++) {
+                    int digit = more() ? hexDigit(peek()) : -1;
+                    if (digit == -1) {
+                        fail("\\x needs two hex digits");
+                    }
+                    value = value * 16 + digit;
+                    position++;
+                }
+                result.set(value);
+                break;
+            }
+            default:
+                result.set(static_cast<unsigned char>(c));
+        }
+        return result;
+    }
+
+    static int hexDigit(char c) {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        }
+        if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
+
+    static int lowest(const bitset<256> &bytes) {
+        for (int b = 0; b < 256; b++) {
+            if (bytes[b]) {
+                return b;
+            }
+        }
+        return -1;
+    }
+
+    int state() {
+        nfa.push_back(NfaState{bitset<256>{}, -1, vector<int>{}, -1});
+        return static_cast<int>(nfa.size()) - 1;
+    }
+
+    bool more() const {
+        return position < rule.pattern.size();
+    }
+
+    char peek() const {
+        return rule.pattern[position];
+    }
+
+    [[noreturn]] void fail(const string &message) const {
+        throw runtime_error("pattern of token " + rule.name + " at " + std::to_string(position) + ": " + message);
+    }
+
+    vector<NfaState> &nfa;
+    const TokenRule &rule;
+    size_t position = 0;
+};
+
+void LexerGenerator::closeOver(vector<int> &states, vector<char> &seen) const {
+    for (size_t i = 0; i < states.size(); i++) {
+        for (auto next : nfa[states[i]].epsilon) {
+            if (!seen[next]) {
+                seen[next] = 1;
+                states.push_back(next);
+            }
+        }
+    }
+    for (auto s : states) {
+        seen[s] = 0;
+    }
+    std::sort(states.begin(), states.end());
+}
+
+LexerGenerator::LexerGenerator(vector<TokenRule> tokenRules) : rules(std::move(tokenRules)), symbols{}, nfa{} {
+    // state 0 branches into every rule
+    nfa.push_back(NfaState{bitset<256>{}, -1, vector<int>{}, -1});
+    vector<char> seen{};
+    for (size_t r = 0; r < rules.size(); r++) {
+        if (rules[r].pattern.empty()) {
+            throw runtime_error("pattern of token " + rules[r].name + " is empty");
+        }
+        auto fragment = PatternParser{nfa, rules[r]}.parse();
+        nfa[fragment.end].rule = static_cast<int>(r);
+        nfa[0].epsilon.push_back(fragment.start);
+        symbols.push_back(Item{rules[r].name, ItemType::Terminal}.getId());
+
+        seen.assign(nfa.size(), 0);
+        vector<int> start{fragment.start};
+        seen[fragment.start] = 1;
+        closeOver(start, seen);
+        if (std::binary_search(start.begin(), start.end(), fragment.end)) {
+            throw runtime_error("pattern of token " + rules[r].name + " matches the empty string");
+        }
+    }
+}
+
+LexerTable LexerGenerator::generate() const {
+    // subset construction, an empty set is the dead state -1
+    vector<vector<int>> sets{};
+    map<vector<int>, int> setIds{};
+    vector<int32_t> transitions{};
+    vector<int> acceptRules{};
+    vector<char> seen(nfa.size(), 0);
+    vector<int> start{0};
+    seen[0] = 1;
+    closeOver(start, seen);
+    setIds.emplace(start, 0);
+    sets.push_back(start);
+    vector<vector<int>> moves(256);
+    for (size_t current = 0; current < sets.size(); current++) {
+        int rule = -1;
+        for (auto &move : moves) {
+            move.clear();
+        }
+        for (auto s : sets[current]) {
+            auto &state = nfa[s];
+            if (state.rule != -1 && (rule == -1 || state.rule < rule)) {
+                rule = state.rule;
+            }
+            if (state.out == -1) {
+                continue;
+            }
+            // every thompson state has its own out state, the moves have no duplicates
+            for (int c = 0; c < 256; c++) {
+                if (state.bytes[c]) {
+                    moves[c].push_back(state.out);
+                }
+            }
+        }
+        acceptRules.push_back(rule);
+        for (int c = 0; c < 256; c++) {
+            auto &move = moves[c];
+            if (move.empty()) {
+                transitions.push_back(-1);
+                continue;
+            }
+            for (auto s : move) {
+                seen[s] = 1;
+            }
+            closeOver(move, seen);
+            auto inserted = setIds.emplace(move, static_cast<int>(sets.size()));
+            if (inserted.second) {
+                sets.push_back(move);
+            }
+            transitions.push_back(inserted.first->second);
+        }
+    }
+
+    // moore minimization, the states start out split by the rule they accept
+    auto count = sets.size();
+    vector<int> group(count);
+    size_t groups = 0;
+    {
+        map<int, int> byRule{};
+        for (size_t s = 0; s < count; s++) {
+            group[s] = byRule.emplace(acceptRules[s], static_cast<int>(byRule.size())).first->second;
+        }
+        groups = byRule.size();
+    }
+    vector<int> signature(257);
+    while (true) {
+        map<vector<int>, int> bySignature{};
+        vector<int> refined(count);
+        for (size_t s = 0; s < count; s++) {
+            signature[0] = group[s];
+            for (int c = 0; c < 256; c++) {
+                int next = transitions[s * 256 + c];
+                signature[c + 1] = next == -1 ? -1 : group[next];
+            }
+            refined[s] = bySignature.emplace(signature, static_cast<int>(bySignature.size())).first->second;
+        }
+        group.swap(refined);
+        if (bySignature.size() == groups) {
+            break;
+        }
+        groups = bySignature.size();
+    }
+
+    // the groups numbered breadth first from the start state
+    vector<int> number(groups, -1);
+    vector<int> representative{};
+    number[group[0]] = 0;
+    representative.push_back(0);
+    for (size_t i = 0; i < representative.size(); i++) {
+        for (int c = 0; c < 256; c++) {
+            int next = transitions[representative[i] * 256 + c];
+            if (next != -1 && number[group[next]] == -1) {
+                number[group[next]] = static_cast<int>(representative.size());
+                representative.push_back(next);
+            }
+        }
+    }
+
+    LexerTable table{};
+    auto states = representative.size();
+    table.transitions.resize(states * 256);
+    table.acceptSymbols.resize(states);
+    table.skipStates.resize(states);
+    table.runClasses.resize(states);
+    for (size_t s = 0; s < states; s++) {
+        int old = representative[s];
+        for (int c = 0; c < 256; c++) {
+            int next = transitions[old * 256 + c];
+            table.transitions[s * 256 + c] = next == -1 ? -1 : number[group[next]];
+        }
+        int rule = acceptRules[old];
+        table.acceptSymbols[s] = rule == -1 ? -1 : symbols[rule];
+        table.skipStates[s] = rule != -1 && rules[rule].skip;
+
+        // the self loop of the state as ranges, or as the bytes missing from it
+        LexerTable::RunClass run{0, false, {}, {}};
+        vector<int> missing{};
+        vector<std::pair<int, int>> ranges{};
+        for (int c = 0; c < 256; c++) {
+            if (table.transitions[s * 256 + c] != static_cast<int>(s)) {
+                missing.push_back(c);
+            } else if (!ranges.empty() && ranges.back().second == c - 1) {
+                ranges.back().second = c;
+            } else {
+                ranges.emplace_back(c, c);
+            }
+        }
+        if (!ranges.empty() && ranges.size() <= 4) {
+            run.count = static_cast<uint8_t>(ranges.size());
+            for (size_t i = 0; i < ranges.size(); i++) {
+                run.low[i] = static_cast<uint8_t>(ranges[i].first);
+                run.high[i] = static_cast<uint8_t>(ranges[i].second);
+            }
+        } else if (!ranges.empty() && missing.size() <= 4) {
+            run.count = static_cast<uint8_t>(missing.size());
+            run.negated = true;
+            for (size_t i = 0; i < missing.size(); i++) {
+                run.low[i] = run.high[i] = static_cast<uint8_t>(missing[i]);
+            }
+        }
+        table.runClasses[s] = run;
+    }
+    return table;
+}
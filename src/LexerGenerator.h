@@ -0,0 +1,96 @@
+#ifndef LEXER_GENERATOR_H
+#define LEXER_GENERATOR_H
+
+#include <bitset>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// one token of a lexer, name is the name of the terminal the token stands for.
+// skip tokens like white space and comments are matched but not handed to the parser
+struct TokenRule {
+    std::string name;
+    std::string pattern;
+    bool skip;
+};
+
+// the minimized dfa of a lexer over bytes, state 0 is the start state and -1 the dead state.
+// a token is the longest match, between matches of the same length the earlier rule wins
+class LexerTable {
+public:
+    // the bytes keeping a state in itself, as up to four byte ranges or as the complement of up to
+    // four bytes. Lexer skips runs of them sixteen bytes at a time
+    struct RunClass {
+        uint8_t count;
+        bool negated;
+        uint8_t low[4];
+        uint8_t high[4];
+    };
+
+    int next(int state, unsigned char c) const {
+        return transitions[static_cast<size_t>(state) * 256 + c];
+    }
+
+    // the terminal symbol id the state accepts, -1 if it accepts nothing
+    int accept(int state) const {
+        return acceptSymbols[state];
+    }
+
+    bool skip(int state) const {
+        return skipStates[state] != 0;
+    }
+
+    const RunClass &runClass(int state) const {
+        return runClasses[state];
+    }
+
+    size_t stateCount() const {
+        return acceptSymbols.size();
+    }
+
+    const std::vector<int32_t> &transitionData() const {
+        return transitions;
+    }
+
+private:
+    friend class LexerGenerator;
+
+    std::vector<int32_t> transitions;
+    std::vector<int> acceptSymbols;
+    std::vector<char> skipStates;
+    std::vector<RunClass> runClasses;
+};
+
+// compiles the token rules into a LexerTable: thompson nfa, subset construction, then moore
+// minimization with the accepting rule as the initial partition.
+// patterns know literals, ., [a-z] and [^...] classes, \d \w \s, \n \t \r \xHH, ( ), |, *, + and ?.
+// the symbol ids are the ones of Item{name, ItemType::Terminal}, so they line up with the parse table.
+class LexerGenerator {
+public:
+    // throws std::runtime_error naming the rule if a pattern is malformed or matches the empty string
+    explicit LexerGenerator(std::vector<TokenRule> tokenRules);
+
+    LexerTable generate() const;
+
+private:
+    struct NfaState {
+        // the bytes leading to out, empty for a state with only ε edges
+        std::bitset<256> bytes;
+        int out;
+        std::vector<int> epsilon;
+        // the index of the rule the state accepts, -1 if it accepts nothing
+        int rule;
+    };
+
+    class PatternParser;
+
+    // extends states, whose members are marked in seen, by their ε closure and sorts them.
+    // seen is cleared again
+    void closeOver(std::vector<int> &states, std::vector<char> &seen) const;
+
+    std::vector<TokenRule> rules;
+    std::vector<int> symbols;
+    std::vector<NfaState> nfa;
+};
+
+#endif
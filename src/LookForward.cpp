@@ -0,0 +1,42 @@
+#include "LookForward.h"
+#include "InternPool.h"
+#include <algorithm>
+#include <iterator>
+
+using std::vector;
+using std::set;
+
+const LookForward &LookForward::intern(const set<Item> &items) {
+    vector<Item> sorted{items.begin(), items.end()};
+    return intern(sorted.data(), sorted.data() + sorted.size());
+}
+
+const LookForward &LookForward::intern(const Item *first, const Item *last) {
+    return InternPool::current().intern(first, last);
+}
+
+const LookForward &LookForward::none() {
+    return InternPool::current().none();
+}
+
+const Item *LookForward::find(const Item &item) const {
+    auto found = std::lower_bound(begin(), end(), item);
+    return found != end() && *found == item ? found : end();
+}
+
+const LookForward &LookForward::merge(const LookForward &other) const {
+    if (this == &other || other.empty()) {
+        return *this;
+    }
+    if (empty()) {
+        return other.owner == owner ? other : owner->intern(other.begin(), other.end());
+    }
+    vector<Item> merged{};
+    merged.reserve(size() + other.size());
+    std::set_union(begin(), end(), other.begin(), other.end(), std::back_inserter(merged));
+    return owner->intern(merged.data(), merged.data() + merged.size());
+}
+
+bool operator==(const LookForward &look, const set<Item> &items) {
+    return look.size() == items.size() && std::equal(look.begin(), look.end(), items.begin());
+}
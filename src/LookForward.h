@@ -0,0 +1,108 @@
+#ifndef LOOK_FORWARD_H
+#define LOOK_FORWARD_H
+
+#include "Item.h"
+#include <cstddef>
+#include <set>
+#include <vector>
+
+class InternPool;
+
+// an interned look forward set: the terminals sorted by id, iterated in the order of a std::set<Item>.
+// equal sets are interned once into the InternPool of the generation, so a Handler only holds a pointer and two
+// sets of a pool are equal exactly if they are the same object. the terminals live in arena chunks of the pool.
+class LookForward {
+public:
+    using const_iterator = const Item *;
+    using iterator = const Item *;
+    using value_type = Item;
+
+    // into InternPool::current()
+    static const LookForward &intern(const std::set<Item> &items);
+
+    // items sorted by id without duplicates
+    static const LookForward &intern(const Item *first, const Item *last);
+
+    static const LookForward &intern(const std::vector<Item> &items) {
+        return intern(items.data(), items.data() + items.size());
+    }
+
+    static const LookForward &none();
+
+    LookForward(const LookForward &) = delete;
+
+    LookForward &operator=(const LookForward &) = delete;
+
+    const Item *begin() const {
+        return first;
+    }
+
+    const Item *end() const {
+        return first + length;
+    }
+
+    size_t size() const {
+        return length;
+    }
+
+    bool empty() const {
+        return length == 0;
+    }
+
+    const Item *find(const Item &item) const;
+
+    size_t count(const Item &item) const {
+        return find(item) != end() ? 1 : 0;
+    }
+
+    // the union with the terminals of other, interned into the pool of this set
+    const LookForward &merge(const LookForward &other) const;
+
+    InternPool &pool() const {
+        return *owner;
+    }
+
+    std::set<Item> toSet() const {
+        return std::set<Item>{begin(), end()};
+    }
+
+    size_t hash() const {
+        return hashValue;
+    }
+
+    bool operator==(const LookForward &other) const {
+        return this == &other;
+    }
+
+    bool operator!=(const LookForward &other) const {
+        return this != &other;
+    }
+
+    friend bool operator==(const LookForward &look, const std::set<Item> &items);
+
+    friend bool operator==(const std::set<Item> &items, const LookForward &look) {
+        return look == items;
+    }
+
+    friend bool operator!=(const LookForward &look, const std::set<Item> &items) {
+        return !(look == items);
+    }
+
+    friend bool operator!=(const std::set<Item> &items, const LookForward &look) {
+        return !(look == items);
+    }
+
+private:
+    friend class InternPool;
+
+    LookForward(const Item *items, size_t size, size_t hash, InternPool *pool) : first{items}, length{size},
+                                                                                 hashValue{hash}, owner{pool} {
+    }
+
+    const Item *first;
+    size_t length;
+    size_t hashValue;
+    InternPool *owner;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef LR_ITEM_H
+#define LR_ITEM_H
+
+#include "BitSet.h"
+#include <utility>
+#include <vector>
+
+// internal form of a Handler: the production is the index into the rule list and
+// the look forward set is a BitSet over the terminal indexes of the grammar.
+struct LrItem {
+    int production;
+    int position;
+    BitSet lookForward;
+};
+
+// internal form of a HandlerSet: symbol is the item shifted into the state and
+// transitions holds the (symbol, target state) pairs leaving it.
+struct LrState {
+    int symbol;
+    int parent;
+    std::vector<LrItem> items;
+    std::vector<std::pair<int, int>> transitions;
+};
+
+#endif
@@ -0,0 +1,73 @@
+#include "LrParser.h"
+#include <stdexcept>
+
+LrParser::LrParser(const ParseTableView &tableRef, int eofSymbol, size_t capacity)
+        : table(tableRef), eofColumn{tableRef.terminalColumn(eofSymbol)}, reduce{},
+          stateStack(capacity < 1 ? 1 : capacity), startStack(stateStack.size()) {
+    if (eofColumn == -1) {
+        throw std::runtime_error("unknown end of input symbol");
+    }
+}
+
+ParseResult LrParser::parse(const int *begin, const int *end) {
+    const int32_t *actions = table.actions;
+    const int32_t *gotos = table.gotos;
+    const int32_t *productions = table.productions;
+    const int32_t *defaults = table.defaults;
+    auto actionWidth = table.terminalWidth;
+    auto gotoWidth = table.noTerminalWidth;
+    auto count = static_cast<size_t>(end - begin);
+    auto columnAt = [&](size_t position) {
+        return position < count ? table.terminalColumn(begin[position]) : eofColumn;
+    };
+    auto push = [this](size_t depth, int state, size_t start) {
+        if (depth == stateStack.size()) {
+            stateStack.resize(depth * 2);
+            startStack.resize(depth * 2);
+        }
+        stateStack[depth] = state;
+        startStack[depth] = start;
+    };
+
+    ParseResult result{false, 0, 0, 0};
+    size_t top = 0;
+    stateStack[0] = 0;
+    startStack[0] = 0;
+    size_t position = 0;
+    int column = columnAt(0);
+    while (column != -1) {
+        int32_t cell = actions[stateStack[top] * actionWidth + column];
+        if (cell == 0 && defaults[stateStack[top]] != -1) {
+            cell = ParseTable::encode(ParseAction{ActionType::Reduce, defaults[stateStack[top]]});
+        }
+        auto type = static_cast<ActionType>(cell & 3);
+        if (type == ActionType::Shift) {
+            push(++top, cell >> 2, position);
+            column = columnAt(++position);
+            result.shifts++;
+        } else if (type == ActionType::Reduce) {
+            int production = cell >> 2;
+            int length = productions[production * 2 + 1];
+            if (static_cast<size_t>(length) > top) {
+                // only a damaged table pops below the start state
+                break;
+            }
+            top -= length;
+            size_t start = length == 0 ? position : startStack[top + 1];
+            if (reduce) {
+                reduce(production, start, position);
+            }
+            int next = gotos[stateStack[top] * gotoWidth + productions[production * 2]];
+            if (next == -1) {
+                break;
+            }
+            push(++top, next, start);
+            result.reductions++;
+        } else {
+            result.accepted = type == ActionType::Accept;
+            break;
+        }
+    }
+    result.position = position;
+    return result;
+}
@@ -0,0 +1,54 @@
+#ifndef LR_PARSER_H
+#define LR_PARSER_H
+
+#include "ParseTable.h"
+#include <functional>
+
+struct ParseResult {
+    bool accepted;
+    // the token the parser stopped at, the number of tokens if it stopped at the end of input
+    size_t position;
+    size_t shifts;
+    size_t reductions;
+};
+
+// runs a ParseTable, or any other ParseTableView, over a stream of terminal symbol ids.
+// an empty action cell takes the default reduction of its state if there is one.
+// the state stack is allocated up front and only grows when a parse nests deeper than it,
+// parsing itself does not allocate.
+class LrParser {
+public:
+    // called for every reduce with the production id and the token range [begin, end) it covers
+    using ReduceCallback = std::function<void(int production, size_t begin, size_t end)>;
+
+    LrParser(const ParseTableView &table, int eofSymbol, size_t stackCapacity = 256);
+
+    LrParser(const ParseTable &table, int eofSymbol, size_t stackCapacity = 256)
+            : LrParser(table.view(), eofSymbol, stackCapacity) {
+    }
+
+    void onReduce(ReduceCallback callback) {
+        reduce = std::move(callback);
+    }
+
+    // the end of input is implied after the last token
+    ParseResult parse(const int *begin, const int *end);
+
+    ParseResult parse(const std::vector<int> &tokens) {
+        return parse(tokens.data(), tokens.data() + tokens.size());
+    }
+
+    size_t stackCapacity() const {
+        return stateStack.size();
+    }
+
+private:
+    ParseTableView table;
+    int eofColumn;
+    ReduceCallback reduce;
+    std::vector<int> stateStack;
+    // the first token of every stack entry
+    std::vector<size_t> startStack;
+};
+
+#endif
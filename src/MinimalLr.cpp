@@ -0,0 +1,164 @@
+#include "MinimalLr.h"
+#include <algorithm>
+#include <set>
+
+using std::vector;
+using std::pair;
+using std::move;
+
+MinimalLrBuilder::MinimalLrBuilder(const Grammar &grammarRef, const FirstFollow &setsRef, ClosureEngine &closureRef)
+        : grammar(grammarRef), sets(setsRef), closure(closureRef) {
+
+}
+
+vector<LrState> MinimalLrBuilder::build() {
+    states.clear();
+    coreIndex.clear();
+    work.clear();
+    reexpanded = 0;
+    BitSet eof{sets.terminalCount()};
+    eof.set(grammar.terminalIndex(grammar.eof()));
+    addState(grammar.eof(), vector<LrItem>{LrItem{grammar.startProduction(), 0, move(eof)}});
+    while (!work.empty()) {
+        int state = work.front();
+        work.pop_front();
+        expand(state);
+    }
+
+    // merges leave states behind which are no longer reachable, number the others breadth first
+    vector<int> number(states.size(), -1);
+    vector<int> parent(states.size(), -1);
+    vector<int> reachable{0};
+    number[0] = 0;
+    for (size_t i = 0; i < reachable.size(); i++) {
+        for (auto &next : states[reachable[i]].transitions) {
+            if (number[next.second] == -1) {
+                number[next.second] = static_cast<int>(reachable.size());
+                parent[next.second] = static_cast<int>(i);
+                reachable.push_back(next.second);
+            }
+        }
+    }
+    vector<LrState> result{};
+    result.reserve(reachable.size());
+    for (auto id : reachable) {
+        auto &state = states[id];
+        vector<pair<int, int>> transitions{};
+        transitions.reserve(state.transitions.size());
+        for (auto &next : state.transitions) {
+            transitions.emplace_back(next.first, number[next.second]);
+        }
+        result.push_back(LrState{state.symbol, parent[id], move(state.items), move(transitions)});
+    }
+    states.clear();
+    coreIndex.clear();
+    return result;
+}
+
+vector<int> MinimalLrBuilder::coreOf(const vector<LrItem> &kernel, vector<int> &order) const {
+    vector<pair<int, int>> sorted{};
+    sorted.reserve(kernel.size());
+    for (size_t slot = 0; slot < kernel.size(); slot++) {
+        sorted.emplace_back(grammar.itemId(kernel[slot].production, kernel[slot].position), static_cast<int>(slot));
+    }
+    std::sort(sorted.begin(), sorted.end());
+    vector<int> core{};
+    core.reserve(sorted.size());
+    order.clear();
+    for (auto &pair : sorted) {
+        core.push_back(pair.first);
+        order.push_back(pair.second);
+    }
+    return core;
+}
+
+bool MinimalLrBuilder::weaklyCompatible(const State &state, const vector<LrItem> &kernel,
+                                        const vector<int> &order) const {
+    auto count = order.size();
+    for (size_t i = 0; i < count; i++) {
+        auto &oldI = state.kernel[state.order[i]].lookForward;
+        auto &newI = kernel[order[i]].lookForward;
+        for (size_t j = i + 1; j < count; j++) {
+            auto &oldJ = state.kernel[state.order[j]].lookForward;
+            auto &newJ = kernel[order[j]].lookForward;
+            if ((oldI.intersects(newJ) || newI.intersects(oldJ)) &&
+                !oldI.intersects(oldJ) && !newI.intersects(newJ)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int MinimalLrBuilder::addState(int symbol, vector<LrItem> kernel) {
+    vector<int> order{};
+    auto core = coreOf(kernel, order);
+    auto &candidates = coreIndex[core];
+    for (auto id : candidates) {
+        auto &state = states[id];
+        bool covered = true;
+        for (size_t k = 0; k < order.size() && covered; k++) {
+            covered = state.kernel[state.order[k]].lookForward.contains(kernel[order[k]].lookForward);
+        }
+        if (covered) {
+            return id;
+        }
+    }
+    for (auto id : candidates) {
+        auto &state = states[id];
+        if (!weaklyCompatible(state, kernel, order)) {
+            continue;
+        }
+        for (size_t k = 0; k < order.size(); k++) {
+            state.kernel[state.order[k]].lookForward.unionWith(kernel[order[k]].lookForward);
+        }
+        // the grown look forward has to reach the successors as well
+        if (!state.queued) {
+            state.queued = true;
+            work.push_back(id);
+            reexpanded++;
+        }
+        return id;
+    }
+    int id = static_cast<int>(states.size());
+    states.push_back(State{symbol, move(kernel), move(order), {}, {}, true});
+    candidates.push_back(id);
+    work.push_back(id);
+    return id;
+}
+
+void MinimalLrBuilder::expand(int state) {
+    states[state].queued = false;
+    vector<LrItem> items{states[state].kernel};
+    closure.close(items);
+    // same order as Context::Goto, the no terminals first and both by symbol id
+    std::set<int> noTerminals{};
+    std::set<int> terminals{};
+    for (auto &item : items) {
+        auto &rhs = grammar.rhs(item.production);
+        if (item.position >= static_cast<int>(rhs.size()) || rhs[item.position] == grammar.epsilon()) {
+            continue;
+        }
+        int symbol = rhs[item.position];
+        (grammar.isTerminal(symbol) ? terminals : noTerminals).insert(symbol);
+    }
+    vector<pair<int, int>> transitions{};
+    auto advance = [&](int symbol) {
+        vector<LrItem> kernel{};
+        for (auto &item : items) {
+            auto &rhs = grammar.rhs(item.production);
+            if (item.position < static_cast<int>(rhs.size()) && rhs[item.position] == symbol) {
+                kernel.push_back(LrItem{item.production, item.position + 1, item.lookForward});
+            }
+        }
+        transitions.emplace_back(symbol, addState(symbol, move(kernel)));
+    };
+    for (auto symbol : noTerminals) {
+        advance(symbol);
+    }
+    for (auto symbol : terminals) {
+        advance(symbol);
+    }
+    states[state].items = move(items);
+    states[state].transitions = move(transitions);
+}
@@ -0,0 +1,56 @@
+#ifndef MINIMAL_LR_H
+#define MINIMAL_LR_H
+
+#include "Grammar.h"
+#include "FirstFollow.h"
+#include "ClosureEngine.h"
+#include "LrItem.h"
+#include <deque>
+#include <map>
+
+// lr(1) automaton with Pager's weak compatibility merging.
+// a new state joins an existing state with the same lr(0) core when for every pair of kernel items i, j
+//   (L[i] ∩ L'[j]) ∪ (L'[i] ∩ L[j]) is empty, or L[i] ∩ L[j] or L'[i] ∩ L'[j] is not empty,
+// so the merge can not introduce a reduce/reduce conflict canonical lr(1) does not have.
+// a state whose look forward grew is expanded again, the states no longer reachable are dropped.
+class MinimalLrBuilder {
+public:
+    MinimalLrBuilder(const Grammar &grammar, const FirstFollow &sets, ClosureEngine &closure);
+
+    std::vector<LrState> build();
+
+    // how often a state was expanded again because a merge grew its look forward
+    size_t reexpansions() const {
+        return reexpanded;
+    }
+
+private:
+    struct State {
+        int symbol;
+        // the kernel in discovery order, closing it keeps the item order of generalLr1()
+        std::vector<LrItem> kernel;
+        // kernel slot of every item of the core, ordered by item id
+        std::vector<int> order;
+        std::vector<LrItem> items;
+        std::vector<std::pair<int, int>> transitions;
+        bool queued;
+    };
+
+    std::vector<int> coreOf(const std::vector<LrItem> &kernel, std::vector<int> &order) const;
+
+    bool weaklyCompatible(const State &state, const std::vector<LrItem> &kernel, const std::vector<int> &order) const;
+
+    int addState(int symbol, std::vector<LrItem> kernel);
+
+    void expand(int state);
+
+    const Grammar &grammar;
+    const FirstFollow &sets;
+    ClosureEngine &closure;
+    std::vector<State> states;
+    std::map<std::vector<int>, std::vector<int>> coreIndex;
+    std::deque<int> work;
+    size_t reexpanded = 0;
+};
+
+#endif
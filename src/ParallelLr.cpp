@@ -0,0 +1,137 @@
+#include "ParallelLr.h"
+#include <algorithm>
+#include <set>
+
+using std::vector;
+using std::pair;
+using std::move;
+
+ParallelLrBuilder::ParallelLrBuilder(const Grammar &grammarRef, const ClosureEngine &closure, ThreadPool &poolRef)
+        : grammar(grammarRef), pool(poolRef), engines(poolRef.size(), closure), shards(shardCount) {
+
+}
+
+vector<LrState> ParallelLrBuilder::build() {
+    states.clear();
+    kernels.clear();
+    BitSet eof{grammar.terminals().size()};
+    eof.set(grammar.terminalIndex(grammar.eof()));
+    vector<LrItem> start{LrItem{grammar.startProduction(), 0, move(eof)}};
+    findOrInsert(start)->id = 0;
+    states.push_back(LrState{grammar.eof(), -1, {}, {}});
+    kernels.push_back(move(start));
+    for (levelBegin = 0; levelBegin < states.size();) {
+        size_t levelEnd = states.size();
+        successors.assign(levelEnd - levelBegin, vector<Successor>{});
+        pool.parallelFor(levelEnd - levelBegin, [this](size_t index, size_t worker) {
+            expand(static_cast<int>(levelBegin + index), worker);
+        });
+        // number the new kernels in discovery order
+        for (size_t s = levelBegin; s < levelEnd; s++) {
+            for (auto &next : successors[s - levelBegin]) {
+                auto entry = next.entry;
+                if (entry->id == -1) {
+                    entry->id = static_cast<int>(states.size());
+                    states.push_back(LrState{next.symbol, static_cast<int>(s), {}, {}});
+                    kernels.push_back(move(next.kernel));
+                }
+                states[s].transitions.emplace_back(next.symbol, entry->id);
+            }
+        }
+        levelBegin = levelEnd;
+    }
+    successors.clear();
+    kernels.clear();
+    probeCount = 0;
+    for (auto &shard : shards) {
+        probeCount += shard.probes;
+        shard.probes = 0;
+        shard.index.clear();
+        shard.entries.clear();
+    }
+    return move(states);
+}
+
+void ParallelLrBuilder::expand(int state, size_t worker) {
+    vector<LrItem> items{move(kernels[state])};
+    engines[worker].close(items);
+    // same order as Context::Goto, the no terminals first and both by symbol id
+    std::set<int> noTerminals{};
+    std::set<int> terminals{};
+    for (auto &item : items) {
+        auto &rhs = grammar.rhs(item.production);
+        if (item.position >= static_cast<int>(rhs.size()) || rhs[item.position] == grammar.epsilon()) {
+            continue;
+        }
+        int symbol = rhs[item.position];
+        (grammar.isTerminal(symbol) ? terminals : noTerminals).insert(symbol);
+    }
+    auto &result = successors[state - levelBegin];
+    auto advance = [&](int symbol) {
+        vector<LrItem> kernel{};
+        for (auto &item : items) {
+            auto &rhs = grammar.rhs(item.production);
+            if (item.position < static_cast<int>(rhs.size()) && rhs[item.position] == symbol) {
+                kernel.push_back(LrItem{item.production, item.position + 1, item.lookForward});
+            }
+        }
+        auto entry = findOrInsert(kernel);
+        result.push_back(Successor{symbol, move(kernel), entry});
+    };
+    for (auto symbol : noTerminals) {
+        advance(symbol);
+    }
+    for (auto symbol : terminals) {
+        advance(symbol);
+    }
+    states[state].items = move(items);
+}
+
+ClosureEngine::Counters ParallelLrBuilder::takeClosureCounters() {
+    ClosureEngine::Counters result{};
+    for (auto &engine : engines) {
+        auto counters = engine.takeCounters();
+        result.closes += counters.closes;
+        result.iterations += counters.iterations;
+        result.merges += counters.merges;
+    }
+    return result;
+}
+
+ParallelLrBuilder::Entry *ParallelLrBuilder::findOrInsert(vector<LrItem> kernel) {
+    // a state is identified by its kernel as a set, compare the kernels sorted by item
+    std::sort(kernel.begin(), kernel.end(), [](const LrItem &a, const LrItem &b) {
+        return a.production != b.production ? a.production < b.production : a.position < b.position;
+    });
+    size_t hash = kernel.size();
+    for (auto &item : kernel) {
+        hash = hash * 31 + static_cast<size_t>(grammar.itemId(item.production, item.position));
+        hash = hash * 31 + item.lookForward.hash();
+    }
+    auto same = [&kernel](const Entry &entry) {
+        if (entry.sorted.size() != kernel.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < kernel.size(); i++) {
+            auto &a = entry.sorted[i];
+            auto &b = kernel[i];
+            if (a.production != b.production || a.position != b.position || a.lookForward != b.lookForward) {
+                return false;
+            }
+        }
+        return true;
+    };
+    auto &shard = shards[(hash >> 7) % shardCount];
+    std::lock_guard<std::mutex> lock{shard.mutex};
+    auto range = shard.index.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        shard.probes++;
+        if (same(*it->second)) {
+            return it->second;
+        }
+    }
+    shard.entries.push_back(Entry{move(kernel), hash, -1});
+    auto entry = &shard.entries.back();
+    shard.index.emplace(hash, entry);
+    return entry;
+}
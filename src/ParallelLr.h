@@ -0,0 +1,69 @@
+#ifndef PARALLEL_LR_H
+#define PARALLEL_LR_H
+
+#include "Grammar.h"
+#include "FirstFollow.h"
+#include "ClosureEngine.h"
+#include "ThreadPool.h"
+#include "LrItem.h"
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+// canonical lr(1) automaton built one breadth first level at a time.
+// the states of a level are closed and expanded on the pool, their successor kernels are looked up in a
+// sharded state map. a serial pass then numbers the new kernels in (state, successor) order, which is the
+// order the single threaded worklist of Context::generalLr1() discovers them in.
+class ParallelLrBuilder {
+public:
+    ParallelLrBuilder(const Grammar &grammar, const ClosureEngine &closure, ThreadPool &pool);
+
+    std::vector<LrState> build();
+
+    // the closure work of every worker since the last call
+    ClosureEngine::Counters takeClosureCounters();
+
+    // kernels compared while looking up the successors of the last build
+    size_t probes() const {
+        return probeCount;
+    }
+
+private:
+    // one kernel of the state map, id stays -1 until the serial pass numbers it
+    struct Entry {
+        std::vector<LrItem> sorted;
+        size_t hash;
+        int id;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_multimap<size_t, Entry *> index;
+        std::deque<Entry> entries;
+        size_t probes = 0;
+    };
+
+    struct Successor {
+        int symbol;
+        std::vector<LrItem> kernel;
+        Entry *entry;
+    };
+
+    Entry *findOrInsert(std::vector<LrItem> kernel);
+
+    void expand(int state, size_t worker);
+
+    static constexpr size_t shardCount = 64;
+
+    const Grammar &grammar;
+    ThreadPool &pool;
+    std::vector<ClosureEngine> engines;
+    std::vector<Shard> shards;
+    std::vector<LrState> states;
+    std::vector<std::vector<LrItem>> kernels;
+    std::vector<std::vector<Successor>> successors;
+    size_t levelBegin = 0;
+    size_t probeCount = 0;
+};
+
+#endif
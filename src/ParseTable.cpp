@@ -0,0 +1,90 @@
+#include "ParseTable.h"
+#include <algorithm>
+
+using std::vector;
+using std::move;
+
+ParseTable::ParseTable(size_t stateCount, vector<int> terminals, vector<int> noTerminals) :
+        states{stateCount},
+        terminalWidth{terminals.size()},
+        noTerminalWidth{noTerminals.size()},
+        actionCells(stateCount * terminals.size(), 0),
+        gotoCells(stateCount * noTerminals.size(), -1),
+        productionShape{},
+        defaultCells(stateCount, -1),
+        explicitErrors(stateCount, 0),
+        terminalSymbols{move(terminals)},
+        noTerminalSymbols{move(noTerminals)},
+        columns{},
+        terminalColumns{} {
+    int bound = 0;
+    for (auto symbol : terminalSymbols) {
+        bound = std::max(bound, symbol + 1);
+    }
+    for (auto symbol : noTerminalSymbols) {
+        bound = std::max(bound, symbol + 1);
+    }
+    columns.assign(bound, -1);
+    terminalColumns.assign(bound, -1);
+    for (int i = 0; i < static_cast<int>(terminalSymbols.size()); i++) {
+        columns[terminalSymbols[i]] = i;
+        terminalColumns[terminalSymbols[i]] = i;
+    }
+    for (int i = 0; i < static_cast<int>(noTerminalSymbols.size()); i++) {
+        columns[noTerminalSymbols[i]] = i;
+    }
+}
+
+bool ParseTable::setAction(int state, int terminal, ParseAction action) {
+    auto &cell = actionCells[state * terminalWidth + terminal];
+    if (cell != 0) {
+        return decode(cell) == action;
+    }
+    cell = encode(action);
+    return true;
+}
+
+void ParseTable::setGoto(int state, int noTerminal, int next) {
+    gotoCells[state * noTerminalWidth + noTerminal] = next;
+}
+
+void ParseTable::setProduction(int production, int noTerminal, int length) {
+    if (productionShape.size() < static_cast<size_t>(production + 1) * 2) {
+        productionShape.resize(static_cast<size_t>(production + 1) * 2, -1);
+    }
+    productionShape[production * 2] = noTerminal;
+    productionShape[production * 2 + 1] = length;
+}
+
+int ParseTable::terminalColumn(int symbol) const {
+    if (symbol < 0 || symbol >= static_cast<int>(columns.size())) {
+        return -1;
+    }
+    int column = columns[symbol];
+    return column != -1 && column < static_cast<int>(terminalWidth) && terminalSymbols[column] == symbol ? column
+                                                                                                          : -1;
+}
+
+int ParseTable::noTerminalColumn(int symbol) const {
+    if (symbol < 0 || symbol >= static_cast<int>(columns.size())) {
+        return -1;
+    }
+    int column = columns[symbol];
+    return column != -1 && column < static_cast<int>(noTerminalWidth) && noTerminalSymbols[column] == symbol
+           ? column : -1;
+}
+
+ParseTable::Footprint ParseTable::footprint() const {
+    Footprint result{};
+    result.actionCells = actionCells.size();
+    result.gotoCells = gotoCells.size();
+    result.actionBytes = actionCells.size() * sizeof(int32_t);
+    result.gotoBytes = gotoCells.size() * sizeof(int32_t);
+    result.actionEntries = static_cast<size_t>(std::count_if(actionCells.begin(), actionCells.end(),
+                                                             [](int32_t cell) { return cell != 0; }));
+    result.gotoEntries = static_cast<size_t>(std::count_if(gotoCells.begin(), gotoCells.end(),
+                                                           [](int32_t cell) { return cell != -1; }));
+    result.defaultEntries = static_cast<size_t>(std::count_if(defaultCells.begin(), defaultCells.end(),
+                                                              [](int32_t cell) { return cell != -1; }));
+    return result;
+}
@@ -0,0 +1,206 @@
+#ifndef PARSE_TABLE_H
+#define PARSE_TABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+enum class ActionType : uint8_t {
+    Error = 0,
+    Accept = 1,
+    Shift = 2,
+    Reduce = 3,
+};
+
+struct ParseAction {
+    ActionType type;
+    // the next state for shift, the production id for reduce
+    int value;
+
+    bool operator==(const ParseAction &other) const {
+        return type == other.type && value == other.value;
+    }
+
+    bool operator!=(const ParseAction &other) const {
+        return !(*this == other);
+    }
+};
+
+// two actions competing for the action cell of state on the terminal symbol
+struct Conflict {
+    int state;
+    int symbol;
+    ParseAction first;
+    ParseAction second;
+};
+
+// non owning view of the cells of a ParseTable or of a mapped table file, what LrParser runs on.
+// terminalColumns maps a symbol id below symbolBound to its terminal column or -1,
+// defaults holds the production every empty action cell of a state reduces by, or -1
+struct ParseTableView {
+    const int32_t *actions;
+    const int32_t *gotos;
+    const int32_t *productions;
+    const int32_t *defaults;
+    const int32_t *terminalColumns;
+    size_t states;
+    size_t terminalWidth;
+    size_t noTerminalWidth;
+    size_t productionCount;
+    size_t symbolBound;
+
+    int terminalColumn(int symbol) const {
+        return symbol >= 0 && static_cast<size_t>(symbol) < symbolBound ? terminalColumns[symbol] : -1;
+    }
+};
+
+// the action and goto tables as two dense row major matrices.
+// the action cells are indexed by [state][terminal index] and hold the action type in the low
+// two bits and its value above, the goto cells are indexed by [state][no terminal index].
+// a state may have a default reduction, taken on the terminals whose action cell is empty.
+class ParseTable {
+public:
+    struct Footprint {
+        size_t actionBytes;
+        size_t gotoBytes;
+        size_t actionEntries;
+        size_t gotoEntries;
+        size_t actionCells;
+        size_t gotoCells;
+        size_t defaultEntries;
+    };
+
+    ParseTable() = default;
+
+    ParseTable(size_t states, std::vector<int> terminals, std::vector<int> noTerminals);
+
+    // the cell as stored, an empty cell of a state with a default reduction is still an Error here
+    ParseAction action(int state, int terminal) const {
+        return decode(actionCells[state * terminalWidth + terminal]);
+    }
+
+    // the next state, -1 if there is no goto entry
+    int goTo(int state, int noTerminal) const {
+        return gotoCells[state * noTerminalWidth + noTerminal];
+    }
+
+    // stores the action if the cell is still empty, returns whether the cell now holds action
+    bool setAction(int state, int terminal, ParseAction action);
+
+    // replaces whatever the cell holds, Error empties it
+    void putAction(int state, int terminal, ParseAction action) {
+        actionCells[state * terminalWidth + terminal] = encode(action);
+    }
+
+    void setGoto(int state, int noTerminal, int next);
+
+    // the production the empty action cells of state reduce by, -1 if they are errors
+    int defaultReduction(int state) const {
+        return defaultCells[state];
+    }
+
+    void setDefaultReduction(int state, int production) {
+        defaultCells[state] = production;
+    }
+
+    // a %nonassoc declaration emptied an action cell of state, it has to stay an error
+    void markExplicitError(int state) {
+        explicitErrors[state] = 1;
+    }
+
+    bool hasExplicitError(int state) const {
+        return explicitErrors[state] != 0;
+    }
+
+    // what a reduce by production does: the goto column of its left hand side and the number of
+    // states it pops, ε productions pop none
+    void setProduction(int production, int noTerminal, int length);
+
+    size_t productionCount() const {
+        return productionShape.size() / 2;
+    }
+
+    int reduceColumn(int production) const {
+        return productionShape[production * 2];
+    }
+
+    int reduceLength(int production) const {
+        return productionShape[production * 2 + 1];
+    }
+
+    size_t stateCount() const {
+        return states;
+    }
+
+    size_t terminalCount() const {
+        return terminalWidth;
+    }
+
+    size_t noTerminalCount() const {
+        return noTerminalWidth;
+    }
+
+    // the symbol id of every terminal/no terminal column
+    const std::vector<int> &terminals() const {
+        return terminalSymbols;
+    }
+
+    const std::vector<int> &noTerminals() const {
+        return noTerminalSymbols;
+    }
+
+    int terminalColumn(int symbol) const;
+
+    int noTerminalColumn(int symbol) const;
+
+    Footprint footprint() const;
+
+    const std::vector<int32_t> &actionData() const {
+        return actionCells;
+    }
+
+    const std::vector<int32_t> &gotoData() const {
+        return gotoCells;
+    }
+
+    // (no terminal column, length) of every production
+    const std::vector<int32_t> &productionData() const {
+        return productionShape;
+    }
+
+    // the default reduction of every state
+    const std::vector<int32_t> &defaultData() const {
+        return defaultCells;
+    }
+
+    ParseTableView view() const {
+        return ParseTableView{actionCells.data(), gotoCells.data(), productionShape.data(), defaultCells.data(),
+                              terminalColumns.data(), states, terminalWidth, noTerminalWidth, productionCount(),
+                              terminalColumns.size()};
+    }
+
+    static int32_t encode(ParseAction action) {
+        return action.type == ActionType::Error ? 0 : static_cast<int32_t>(action.value) * 4 +
+                                                      static_cast<int32_t>(action.type);
+    }
+
+    static ParseAction decode(int32_t cell) {
+        return ParseAction{static_cast<ActionType>(cell & 3), cell >> 2};
+    }
+
+private:
+    size_t states = 0;
+    size_t terminalWidth = 0;
+    size_t noTerminalWidth = 0;
+    std::vector<int32_t> actionCells;
+    std::vector<int32_t> gotoCells;
+    std::vector<int32_t> productionShape;
+    std::vector<int32_t> defaultCells;
+    std::vector<char> explicitErrors;
+    std::vector<int> terminalSymbols;
+    std::vector<int> noTerminalSymbols;
+    std::vector<int> columns;
+    std::vector<int32_t> terminalColumns;
+};
+
+#endif
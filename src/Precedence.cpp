@@ -0,0 +1,110 @@
+#include "Precedence.h"
+#include "SymbolTable.h"
+#include <algorithm>
+
+using std::vector;
+using std::string;
+using std::to_string;
+
+void Precedence::declare(Associativity associativity, const vector<int> &terminals) {
+    ++levels;
+    for (auto symbol : terminals) {
+        symbolLevels[symbol] = Level{levels, associativity};
+    }
+}
+
+void Precedence::setProduction(int production, int terminal) {
+    productionSymbols[production] = terminal;
+}
+
+int Precedence::level(int symbol) const {
+    auto ptr = symbolLevels.find(symbol);
+    return ptr == symbolLevels.end() ? 0 : ptr->second.level;
+}
+
+vector<int> Precedence::productionLevels(const Grammar &grammar) const {
+    vector<int> result(grammar.productionCount(), 0);
+    for (int p = 0; p < static_cast<int>(result.size()); p++) {
+        auto ptr = productionSymbols.find(p);
+        if (ptr != productionSymbols.end()) {
+            result[p] = level(ptr->second);
+            continue;
+        }
+        auto &rhs = grammar.rhs(p);
+        for (auto symbol = rhs.rbegin(); symbol != rhs.rend(); ++symbol) {
+            if (grammar.isTerminal(*symbol) && level(*symbol) != 0) {
+                result[p] = level(*symbol);
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+Precedence::Resolution Precedence::resolve(int productionLevel, int terminal) const {
+    auto ptr = symbolLevels.find(terminal);
+    if (productionLevel == 0 || ptr == symbolLevels.end()) {
+        return Resolution::Unresolved;
+    }
+    auto &shiftLevel = ptr->second;
+    if (productionLevel != shiftLevel.level) {
+        return productionLevel > shiftLevel.level ? Resolution::Reduce : Resolution::Shift;
+    }
+    switch (shiftLevel.associativity) {
+        case Associativity::Left:
+            return Resolution::Reduce;
+        case Associativity::Right:
+            return Resolution::Shift;
+        default:
+            return Resolution::Error;
+    }
+}
+
+ParseAction Precedence::choose(const vector<int> &productionLevels, int terminal, const vector<ParseAction> &actions,
+                               bool &resolved) const {
+    resolved = false;
+    // an accept comes first, then the shift, then the reduces by production
+    auto &first = actions.front();
+    auto reduce = std::find_if(actions.begin(), actions.end(),
+                               [](const ParseAction &action) { return action.type == ActionType::Reduce; });
+    if (first.type != ActionType::Shift || reduce == actions.end()) {
+        return first;
+    }
+    switch (resolve(productionLevels[reduce->value], terminal)) {
+        case Resolution::Reduce:
+            resolved = true;
+            return *reduce;
+        case Resolution::Shift:
+            resolved = true;
+            return first;
+        case Resolution::Error:
+            resolved = true;
+            return ParseAction{ActionType::Error, 0};
+        default:
+            return first;
+    }
+}
+
+string Precedence::signature() const {
+    auto &symbols = SymbolTable::global();
+    // the names are length prefixed, so no name can run into the next field
+    auto name = [&symbols](int symbol) {
+        auto &text = symbols.name(symbol);
+        return to_string(text.size()) + ":" + text;
+    };
+    vector<string> lines{};
+    for (auto &symbol : symbolLevels) {
+        lines.push_back("level " + to_string(symbol.second.level) + " " +
+                        to_string(static_cast<int>(symbol.second.associativity)) + " " + name(symbol.first));
+    }
+    for (auto &production : productionSymbols) {
+        lines.push_back("prec " + to_string(production.first) + " " + name(production.second));
+    }
+    std::sort(lines.begin(), lines.end());
+    string result{};
+    for (auto &line : lines) {
+        result += line;
+        result.push_back('\n');
+    }
+    return result;
+}
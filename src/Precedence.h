@@ -0,0 +1,65 @@
+#ifndef PRECEDENCE_H
+#define PRECEDENCE_H
+
+#include "Grammar.h"
+#include "ParseTable.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+enum class Associativity : uint8_t {
+    Left,
+    Right,
+    NonAssoc,
+};
+
+// yacc style %left/%right/%nonassoc levels of terminals, every declaration is a new level binding tighter
+// than the ones before. a production takes the level of its %prec terminal, otherwise the one of its last
+// terminal that has a level.
+class Precedence {
+public:
+    // what a cell with a shift on a terminal and a reduce by a production becomes
+    enum class Resolution : uint8_t {
+        Unresolved,
+        Shift,
+        Reduce,
+        Error,
+    };
+
+    void declare(Associativity associativity, const std::vector<int> &terminals);
+
+    void setProduction(int production, int terminal);
+
+    bool empty() const {
+        return symbolLevels.empty();
+    }
+
+    // the level of symbol, 0 if it has none
+    int level(int symbol) const;
+
+    // the level of every production of grammar
+    std::vector<int> productionLevels(const Grammar &grammar) const;
+
+    Resolution resolve(int productionLevel, int terminal) const;
+
+    // the levels and %prec terminals by symbol name, equal for equal declarations in every process
+    std::string signature() const;
+
+    // the action a cell keeps out of all the actions asked for it, sorted by type and value, with Error for a
+    // %nonassoc cell. as in yacc the lowest production wins a reduce/reduce conflict and the shift is decided
+    // against that production alone. resolved is true if the levels decided the shift, without levels it wins
+    ParseAction choose(const std::vector<int> &productionLevels, int terminal, const std::vector<ParseAction> &actions,
+                       bool &resolved) const;
+
+private:
+    struct Level {
+        int level;
+        Associativity associativity;
+    };
+
+    std::unordered_map<int, Level> symbolLevels;
+    std::unordered_map<int, int> productionSymbols;
+    int levels = 0;
+};
+
+#endif
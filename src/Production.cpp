@@ -15,23 +15,27 @@ const Item &Production::operator[](size_t index) {
     return handleList.at(index);
 }
 
+const Item &Production::operator[](size_t index) const {
+    return handleList.at(index);
+}
+
 bool Production::operator==(const Production &other) const {
     return this->name == other.name;
 }
 
-Item Production::first() {
+Item Production::first() const {
     return this->operator[](0);
 }
 
-size_t Production::size() {
+size_t Production::size() const {
     return handleList.size();
 }
 
-Item Production::last() {
+Item Production::last() const {
     return handleList.back();
 }
 
-Item Production::getItem() {
+Item Production::getItem() const {
     return name;
 }
 
@@ -43,6 +47,14 @@ std::vector<Item>::iterator Production::end() {
     return handleList.end();
 }
 
+std::vector<Item>::const_iterator Production::begin() const {
+    return handleList.begin();
+}
+
+std::vector<Item>::const_iterator Production::end() const {
+    return handleList.end();
+}
+
 bool Production::isNullable() const {
     return find(handleList.begin(), handleList.end(), EMPTY) != handleList.end();
 }
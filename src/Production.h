@@ -6,19 +6,17 @@
 #include <vector>
 #include <algorithm>
 
-class Handler;
-
 class Production {
 public:
-    friend class Handler;
-
     Production(Item name, const std::vector<Item> &handleList);
 
     bool operator==(const Production &other) const;
 
     const Item &operator[](size_t index);
 
-    std::string getName() const {
+    const Item &operator[](size_t index) const;
+
+    const std::string &getName() const {
         return name.getName();
     }
 
@@ -26,13 +24,17 @@ public:
 
     std::vector<Item>::iterator end();
 
-    Item getItem();
+    std::vector<Item>::const_iterator begin() const;
+
+    std::vector<Item>::const_iterator end() const;
+
+    Item getItem() const;
 
-    size_t size();
+    size_t size() const;
 
-    Item first();
+    Item first() const;
 
-    Item last();
+    Item last() const;
 
     bool isNullable() const;
 
@@ -0,0 +1,33 @@
+#include "ProductionTable.h"
+#include "InternPool.h"
+#include <algorithm>
+
+using std::lock_guard;
+using std::mutex;
+
+ProductionTable &ProductionTable::global() {
+    return InternPool::current().productions();
+}
+
+const Production &ProductionTable::intern(const Production &production) {
+    size_t hash = static_cast<size_t>(production.getItem().getId());
+    for (auto &item : production) {
+        hash = hash * 31 + static_cast<size_t>(item.getId());
+    }
+    lock_guard<mutex> lock{productionMutex};
+    auto &candidates = index[hash];
+    for (auto candidate : candidates) {
+        if (candidate->getItem() == production.getItem() && candidate->size() == production.size() &&
+            std::equal(candidate->begin(), candidate->end(), production.begin())) {
+            return *candidate;
+        }
+    }
+    productions.push_back(production);
+    candidates.push_back(&productions.back());
+    return productions.back();
+}
+
+size_t ProductionTable::size() const {
+    lock_guard<mutex> lock{productionMutex};
+    return productions.size();
+}
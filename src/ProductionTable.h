@@ -0,0 +1,30 @@
+#ifndef PRODUCTION_TABLE_H
+#define PRODUCTION_TABLE_H
+
+#include "Production.h"
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+// hash conses the productions of the grammars of a generation: equal productions (same left side and handle) are
+// stored once and a Handler points at the shared copy instead of holding its own. the copies live as long as the
+// InternPool owning the table.
+class ProductionTable {
+public:
+    // the table of InternPool::current()
+    static ProductionTable &global();
+
+    ProductionTable() = default;
+
+    const Production &intern(const Production &production);
+
+    size_t size() const;
+
+private:
+
+    mutable std::mutex productionMutex;
+    std::deque<Production> productions;
+    std::unordered_map<size_t, std::vector<const Production *>> index;
+};
+
+#endif
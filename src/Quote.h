@@ -0,0 +1,33 @@
+#ifndef QUOTE_H
+#define QUOTE_H
+
+#include <string>
+
+// text as a double quoted literal, read the same way by json and c++
+inline std::string quote(const std::string &text) {
+    std::string result{"\""};
+    for (auto c : text) {
+        switch (c) {
+            case '"':
+            case '\\':
+                result.push_back('\\');
+                result.push_back(c);
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\r':
+                result += "\\r";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            default:
+                result.push_back(c);
+        }
+    }
+    result.push_back('"');
+    return result;
+}
+
+#endif
@@ -0,0 +1,25 @@
+#include "StateIndex.h"
+
+using std::vector;
+
+StateIndex::StateIndex(const vector<HandlerSet> &stateSet) : states{stateSet}, index{} {
+    index.reserve(stateSet.size() * 2);
+    for (int i = 0; i < static_cast<int>(stateSet.size()); i++) {
+        insert(stateSet[i], i);
+    }
+}
+
+int StateIndex::find(const HandlerSet &state) const {
+    auto range = index.equal_range(state.kernelHash());
+    for (auto ptr = range.first; ptr != range.second; ++ptr) {
+        probeCount++;
+        if (states[ptr->second].sameKernel(state)) {
+            return ptr->second;
+        }
+    }
+    return -1;
+}
+
+void StateIndex::insert(const HandlerSet &state, int id) {
+    index.emplace(state.kernelHash(), id);
+}
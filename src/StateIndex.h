@@ -0,0 +1,27 @@
+#ifndef STATE_INDEX_H
+#define STATE_INDEX_H
+
+#include "HandlerSet.h"
+#include <unordered_map>
+
+// maps the kernel hash of a lr(1) state to the ids of the states with that hash,
+// so finding an existing state does not compare it against every other state.
+class StateIndex {
+public:
+    explicit StateIndex(const std::vector<HandlerSet> &stateSet);
+
+    int find(const HandlerSet &state) const;
+
+    void insert(const HandlerSet &state, int id);
+
+    size_t probes() const {
+        return probeCount;
+    }
+
+private:
+    const std::vector<HandlerSet> &states;
+    std::unordered_multimap<size_t, int> index;
+    mutable size_t probeCount = 0;
+};
+
+#endif
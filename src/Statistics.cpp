@@ -0,0 +1,158 @@
+#include "Statistics.h"
+#include "Quote.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+using std::string;
+using std::ostringstream;
+using std::runtime_error;
+
+namespace {
+
+// whether a counting operator new is linked in
+std::atomic<bool> heapCounted{false};
+// the bytes live on the heap and the most that were live since the innermost phase started
+std::atomic<long long> liveBytes{0};
+std::atomic<long long> peakBytes{0};
+std::atomic<size_t> allocationCount{0};
+// the counters are the ones of the whole process, so one Statistics at a time measures with them
+std::atomic<const Statistics *> heapOwner{nullptr};
+
+void writeFile(const string &path, const string &text) {
+    std::ofstream out{path, std::ios::trunc};
+    out << text;
+    if (!out) {
+        throw runtime_error("can not write statistics file " + path);
+    }
+}
+
+}
+
+Statistics::Scope::Scope(Statistics &statistics, const char *name) : owner(statistics),
+                                                                    index(statistics.phaseList.size()),
+                                                                    begin(std::chrono::steady_clock::now()) {
+    if (owner.depth == 0) {
+        const Statistics *none = nullptr;
+        owner.measuresHeap = heapOwner.compare_exchange_strong(none, &owner);
+    }
+    if (owner.measuresHeap) {
+        baseline = liveBytes.load(std::memory_order_relaxed);
+        allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+        outerPeak = peakBytes.exchange(baseline, std::memory_order_relaxed);
+    }
+    auto start = std::chrono::duration<double, std::milli>(begin - owner.created).count();
+    owner.phaseList.push_back(Phase{name, owner.depth, start, 0, 0, 0});
+    owner.depth++;
+}
+
+Statistics::Scope::~Scope() {
+    auto &phase = owner.phaseList[index];
+    phase.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    if (owner.measuresHeap) {
+        auto peak = peakBytes.load(std::memory_order_relaxed);
+        phase.peakBytes = static_cast<size_t>(std::max(0LL, peak - baseline));
+        phase.allocations = allocationCount.load(std::memory_order_relaxed) - allocationsBefore;
+        // the enclosing phase saw this peak as well
+        peakBytes.store(std::max(peak, outerPeak), std::memory_order_relaxed);
+    }
+    owner.depth--;
+    if (owner.depth == 0 && owner.measuresHeap) {
+        owner.measuresHeap = false;
+        heapOwner.store(nullptr);
+    }
+}
+
+Statistics::Statistics() : created(std::chrono::steady_clock::now()), phaseList{}, counterSet{} {
+
+}
+
+double Statistics::milliseconds(const string &name) const {
+    double total = 0;
+    for (auto &phase : phaseList) {
+        if (phase.depth == 0 && phase.name == name) {
+            total += phase.milliseconds;
+        }
+    }
+    return total;
+}
+
+void Statistics::clear() {
+    created = std::chrono::steady_clock::now();
+    phaseList.clear();
+    counterSet = Counters{};
+}
+
+string Statistics::json() const {
+    ostringstream out{};
+    out << "{\n  \"heapCounting\": " << (countsHeap() ? "true" : "false") << ",\n  \"phases\": [";
+    for (size_t i = 0; i < phaseList.size(); i++) {
+        auto &phase = phaseList[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {\"name\": " << quote(phase.name) << ", \"depth\": " << phase.depth
+            << ", \"start\": " << phase.start << ", \"milliseconds\": " << phase.milliseconds
+            << ", \"peakBytes\": " << phase.peakBytes << ", \"allocations\": " << phase.allocations << "}";
+    }
+    auto &c = counterSet;
+    out << "\n  ],\n  \"counters\": {\"closureCalls\": " << c.closureCalls << ", \"closureCacheHits\": "
+        << c.closureCacheHits << ", \"gotoCalls\": " << c.gotoCalls << ", \"fixpointIterations\": "
+        << c.fixpointIterations << ", \"dedupProbes\": " << c.dedupProbes << ", \"lookaheadMerges\": "
+        << c.lookaheadMerges << "}\n}\n";
+    return out.str();
+}
+
+string Statistics::chromeTrace() const {
+    ostringstream out{};
+    out << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+    // the trace format counts in microseconds
+    double end = 0;
+    for (size_t i = 0; i < phaseList.size(); i++) {
+        auto &phase = phaseList[i];
+        end = std::max(end, phase.start + phase.milliseconds);
+        out << (i == 0 ? "\n" : ",\n") << "  {\"name\": " << quote(phase.name)
+            << ", \"cat\": \"lr1\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": " << phase.start * 1000
+            << ", \"dur\": " << phase.milliseconds * 1000 << ", \"args\": {\"peakBytes\": " << phase.peakBytes
+            << ", \"allocations\": " << phase.allocations << "}}";
+    }
+    auto &c = counterSet;
+    out << (phaseList.empty() ? "\n" : ",\n") << "  {\"name\": \"counters\", \"ph\": \"C\", \"pid\": 1, \"ts\": "
+        << end * 1000 << ", \"args\": {\"closureCalls\": " << c.closureCalls << ", \"closureCacheHits\": "
+        << c.closureCacheHits << ", \"gotoCalls\": " << c.gotoCalls << ", \"fixpointIterations\": "
+        << c.fixpointIterations << ", \"dedupProbes\": " << c.dedupProbes << ", \"lookaheadMerges\": "
+        << c.lookaheadMerges << "}}\n]}\n";
+    return out.str();
+}
+
+void Statistics::writeJson(const string &path) const {
+    writeFile(path, json());
+}
+
+void Statistics::writeChromeTrace(const string &path) const {
+    writeFile(path, chromeTrace());
+}
+
+size_t Statistics::allocations() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+bool Statistics::countsHeap() {
+    return heapCounted.load(std::memory_order_relaxed);
+}
+
+void Statistics::enableHeapCounting() {
+    heapCounted.store(true, std::memory_order_relaxed);
+}
+
+void Statistics::heapAllocated(size_t bytes) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    auto live = liveBytes.fetch_add(static_cast<long long>(bytes), std::memory_order_relaxed) +
+                static_cast<long long>(bytes);
+    auto peak = peakBytes.load(std::memory_order_relaxed);
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void Statistics::heapReleased(size_t bytes) {
+    liveBytes.fetch_sub(static_cast<long long>(bytes), std::memory_order_relaxed);
+}
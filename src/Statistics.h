@@ -0,0 +1,120 @@
+#ifndef STATISTICS_H
+#define STATISTICS_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// where a Context spent its generation: the wall time and peak heap of every phase and the work counters of
+// the lr(1) construction. phases nest, a phase started inside another one is a part of its time.
+// the heap is counted by the operator new of HeapStatistics.cpp, which replaces the global one of a program. the
+// lr1 library leaves it out, peakBytes and allocations stay 0 in a program not linking it. the counts are the
+// ones of the whole process, so while the phases of one Statistics measure the heap the phases of another one
+// started meanwhile leave both at 0.
+class Statistics {
+public:
+    struct Phase {
+        std::string name;
+        // 0 for the phases started outside of any other
+        int depth;
+        // milliseconds since the statistics were created or cleared
+        double start;
+        double milliseconds;
+        // the most heap bytes live during the phase on top of the ones live when it started
+        size_t peakBytes;
+        // the calls of operator new during the phase, by any thread
+        size_t allocations;
+    };
+
+    struct Counters {
+        // closures computed, a closure found in the closure cache is a hit instead
+        size_t closureCalls = 0;
+        size_t closureCacheHits = 0;
+        // states expanded into their successors
+        size_t gotoCalls = 0;
+        // steps of the look forward fixpoint of ClosureEngine::prepare() and no terminals expanded by a closure
+        size_t fixpointIterations = 0;
+        // kernels compared while looking for an existing state
+        size_t dedupProbes = 0;
+        // look forward sets which grew by a merge while closing, of a reached no terminal or of an item
+        size_t lookaheadMerges = 0;
+    };
+
+    // records a phase from its construction to its destruction
+    class Scope {
+    public:
+        Scope(Statistics &statistics, const char *name);
+
+        Scope(const Scope &) = delete;
+
+        Scope &operator=(const Scope &) = delete;
+
+        ~Scope();
+
+    private:
+        Statistics &owner;
+        size_t index;
+        std::chrono::steady_clock::time_point begin;
+        long long baseline = 0;
+        long long outerPeak = 0;
+        size_t allocationsBefore = 0;
+    };
+
+    Statistics();
+
+    Scope phase(const char *name) {
+        return Scope{*this, name};
+    }
+
+    // the phases in the order they started
+    const std::vector<Phase> &phases() const {
+        return phaseList;
+    }
+
+    Counters &counters() {
+        return counterSet;
+    }
+
+    const Counters &counters() const {
+        return counterSet;
+    }
+
+    // the sum of the top level phases named name
+    double milliseconds(const std::string &name) const;
+
+    void clear();
+
+    // {"heapCounting": ..., "phases": [...], "counters": {...}}
+    std::string json() const;
+
+    // the chrome://tracing and perfetto trace event format, every phase is a complete event
+    std::string chromeTrace() const;
+
+    // both throw std::runtime_error if the file can not be written
+    void writeJson(const std::string &path) const;
+
+    void writeChromeTrace(const std::string &path) const;
+
+    // whether this build counts the heap
+    static bool countsHeap();
+
+    // the calls of operator new since the program started, 0 without heap counting
+    static size_t allocations();
+
+    // what the counting operator new reports
+    static void enableHeapCounting();
+
+    static void heapAllocated(size_t bytes);
+
+    static void heapReleased(size_t bytes);
+
+private:
+    std::chrono::steady_clock::time_point created;
+    std::vector<Phase> phaseList;
+    Counters counterSet;
+    int depth = 0;
+    // whether the phases running now measure the heap
+    bool measuresHeap = false;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#include "SymbolTable.h"
+
+using std::string;
+using std::lock_guard;
+using std::mutex;
+
+SymbolTable &SymbolTable::global() {
+    static SymbolTable table{};
+    return table;
+}
+
+int SymbolTable::intern(const string &name, ItemType type) {
+    lock_guard<mutex> lock{symbolMutex};
+    auto &ids = type == ItemType::Terminal ? terminalIds : noTerminalIds;
+    auto ptr = ids.find(name);
+    if (ptr != ids.end()) {
+        return ptr->second;
+    }
+    int id = static_cast<int>(names.size());
+    names.push_back(name);
+    types.push_back(type);
+    ids.emplace(name, id);
+    return id;
+}
+
+int SymbolTable::find(const string &name, ItemType type) const {
+    lock_guard<mutex> lock{symbolMutex};
+    auto &ids = type == ItemType::Terminal ? terminalIds : noTerminalIds;
+    auto ptr = ids.find(name);
+    return ptr == ids.end() ? -1 : ptr->second;
+}
+
+const string &SymbolTable::name(int id) const {
+    lock_guard<mutex> lock{symbolMutex};
+    return names.at(id);
+}
+
+ItemType SymbolTable::type(int id) const {
+    lock_guard<mutex> lock{symbolMutex};
+    return types.at(id);
+}
+
+size_t SymbolTable::size() const {
+    lock_guard<mutex> lock{symbolMutex};
+    return names.size();
+}
@@ -0,0 +1,41 @@
+#ifndef SYMBOL_TABLE_H
+#define SYMBOL_TABLE_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+
+enum class ItemType {
+    NoTerminal = 0,
+    Terminal = 1,
+};
+
+// interns every terminal/no terminal name once and hands out a dense integer id for it.
+// the names are only kept for printing, everything else compares the ids.
+class SymbolTable {
+public:
+    static SymbolTable &global();
+
+    int intern(const std::string &name, ItemType type);
+
+    int find(const std::string &name, ItemType type) const;
+
+    const std::string &name(int id) const;
+
+    ItemType type(int id) const;
+
+    size_t size() const;
+
+private:
+    SymbolTable() = default;
+
+    mutable std::mutex symbolMutex;
+    std::unordered_map<std::string, int> terminalIds;
+    std::unordered_map<std::string, int> noTerminalIds;
+    std::deque<std::string> names;
+    std::deque<ItemType> types;
+};
+
+#endif
@@ -0,0 +1,350 @@
+#include "TableCache.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_map>
+#include <unistd.h>
+
+extern const Item Eof;
+
+using std::string;
+using std::vector;
+using std::to_string;
+using std::runtime_error;
+
+namespace {
+
+constexpr uint32_t byteOrderMark = 0x01020304;
+
+void describe(string &text, const Production &production) {
+    // the names are length prefixed, so no name can run into the next one
+    auto symbol = [&text](const Item &item) {
+        text += item.isTerminal() ? 't' : 'n';
+        text += to_string(item.getName().size());
+        text += ':';
+        text += item.getName();
+    };
+    symbol(production.getItem());
+    text += " ->";
+    for (auto &item : production) {
+        text += ' ';
+        symbol(item);
+    }
+    text += '\n';
+}
+
+// 64 bit FNV-1a
+uint64_t fnv(const string &text, uint64_t hash) {
+    for (auto c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// writes through a temporary file in the same directory, rename replaces the target atomically
+template<typename Write>
+void writeAtomically(const string &path, Write write) {
+    static std::atomic<unsigned> sequence{0};
+    auto temporary = path + ".tmp." + to_string(::getpid()) + "." + to_string(sequence.fetch_add(1));
+    try {
+        write(temporary);
+    } catch (...) {
+        std::remove(temporary.c_str());
+        throw;
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw runtime_error("can not rename " + temporary + " to " + path);
+    }
+}
+
+class Writer {
+public:
+    void u32(uint32_t value) {
+        bytes.append(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+    void text(const string &value) {
+        u32(static_cast<uint32_t>(value.size()));
+        bytes += value;
+    }
+
+    const string &data() const {
+        return bytes;
+    }
+
+private:
+    string bytes;
+};
+
+class Reader {
+public:
+    explicit Reader(vector<char> data) : bytes{std::move(data)} {
+    }
+
+    uint32_t u32() {
+        uint32_t value{};
+        need(sizeof(value));
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        offset += sizeof(value);
+        return value;
+    }
+
+    // a count of entries of at least entryBytes each, bounded by what is left of the file
+    uint32_t count(size_t entryBytes) {
+        auto value = u32();
+        need(value * entryBytes);
+        return value;
+    }
+
+    string text() {
+        auto size = count(1);
+        string value{bytes.data() + offset, size};
+        offset += size;
+        return value;
+    }
+
+    bool end() const {
+        return offset == bytes.size();
+    }
+
+private:
+    void need(size_t size) const {
+        if (size > bytes.size() - offset) {
+            throw runtime_error("truncated state file");
+        }
+    }
+
+    vector<char> bytes;
+    size_t offset = 0;
+};
+
+}
+
+TableCache::TableCache(string directory) : root{std::move(directory)} {
+    std::error_code error{};
+    std::filesystem::create_directories(root, error);
+    if (error || !std::filesystem::is_directory(root)) {
+        throw runtime_error("can not create cache directory " + root);
+    }
+}
+
+string TableCache::key(const Context &context, GenerationMode mode) {
+    string text{"lr1 cache " + to_string(version) + " table " + to_string(TableFile::version) + "\nmode " +
+                to_string(static_cast<int>(mode)) + "\nstart "};
+    describe(text, context.getStart());
+    for (auto &production : context.getRules()) {
+        describe(text, production);
+    }
+    text += context.getPrecedence().signature();
+    // two independent 64 bit hashes, an accidental collision of both is out of reach
+    char name[33];
+    std::snprintf(name, sizeof(name), "%016llx%016llx",
+                  static_cast<unsigned long long>(fnv(text, 0xcbf29ce484222325ull)),
+                  static_cast<unsigned long long>(fnv(text, 0x84222325cbf29ce4ull)));
+    return name;
+}
+
+string TableCache::path(const string &key, const char *extension) const {
+    return (std::filesystem::path{root} / (key + extension)).string();
+}
+
+std::unique_ptr<TableFile> TableCache::table(Context &context, GenerationMode mode) {
+    auto entry = key(context, mode);
+    auto file = path(entry, ".lr1t");
+    try {
+        auto result = std::make_unique<TableFile>(file);
+        hitCount++;
+        return result;
+    } catch (const runtime_error &) {
+        // missing or damaged, generating replaces it
+    }
+    missCount++;
+    generate(context, mode, entry);
+    return std::make_unique<TableFile>(file);
+}
+
+vector<HandlerSet> TableCache::states(Context &context, GenerationMode mode) {
+    auto entry = key(context, mode);
+    try {
+        auto result = readStates(context, path(entry, ".lr1s"));
+        hitCount++;
+        return result;
+    } catch (const runtime_error &) {
+    }
+    missCount++;
+    return generate(context, mode, entry);
+}
+
+vector<HandlerSet> TableCache::generate(Context &context, GenerationMode mode, const string &key) {
+    vector<HandlerSet> result{};
+    switch (mode) {
+        case GenerationMode::Lr1:
+            result = context.generalLr1();
+            break;
+        case GenerationMode::Lalr1:
+            result = context.generateLalr1();
+            break;
+        case GenerationMode::MinimalLr1:
+            result = context.generateMinimalLr1();
+            break;
+    }
+    auto table = context.table(result);
+    writeAtomically(path(key, ".lr1s"), [&](const string &temporary) {
+        writeStates(context, result, temporary);
+    });
+    writeAtomically(path(key, ".lr1t"), [&](const string &temporary) {
+        TableFile::write(table, Eof.getId(), temporary);
+    });
+    return result;
+}
+
+// uint32 magic, version, byte order, rules, symbols, states
+// every symbol: uint32 0 for a terminal or 1, its name as uint32 length and bytes
+// every state: uint32 shift symbol, parent, handlers, every handler: uint32 rule, position, look forward symbols
+//   and the symbols; uint32 transitions, every transition: uint32 symbol, target
+// symbols are indices into the symbol list, rules into the rule list of the context
+void TableCache::writeStates(const Context &context, const vector<HandlerSet> &states, const string &path) const {
+    auto &productions = ProductionTable::global();
+    std::unordered_map<const Production *, uint32_t> rules{};
+    for (size_t i = 0; i < context.getRules().size(); i++) {
+        rules.emplace(&productions.intern(context.getRules()[i]), static_cast<uint32_t>(i));
+    }
+    vector<int> symbols{};
+    std::unordered_map<int, uint32_t> symbolIndex{};
+    auto symbol = [&symbols, &symbolIndex](int id) {
+        auto inserted = symbolIndex.emplace(id, static_cast<uint32_t>(symbols.size()));
+        if (inserted.second) {
+            symbols.push_back(id);
+        }
+        return inserted.first->second;
+    };
+
+    Writer body{};
+    for (auto &state : states) {
+        body.u32(symbol(state.shiftItem().getId()));
+        body.u32(static_cast<uint32_t>(state.getParentId()));
+        body.u32(static_cast<uint32_t>(state.ruleList().size()));
+        for (auto &handler : state.ruleList()) {
+            auto rule = rules.find(&handler.getProduction());
+            if (rule == rules.end()) {
+                throw runtime_error("state of a production which is not a part of the grammar");
+            }
+            body.u32(rule->second);
+            body.u32(static_cast<uint32_t>(handler.getPosition()));
+            body.u32(static_cast<uint32_t>(handler.getLookForward().size()));
+            for (auto &look : handler.getLookForward()) {
+                body.u32(symbol(look.getId()));
+            }
+        }
+        body.u32(static_cast<uint32_t>(state.transitionList().size()));
+        for (auto &transition : state.transitionList()) {
+            body.u32(symbol(transition.first));
+            body.u32(static_cast<uint32_t>(transition.second));
+        }
+    }
+
+    Writer head{};
+    head.u32(magic);
+    head.u32(version);
+    head.u32(byteOrderMark);
+    head.u32(static_cast<uint32_t>(context.getRules().size()));
+    head.u32(static_cast<uint32_t>(symbols.size()));
+    head.u32(static_cast<uint32_t>(states.size()));
+    for (auto id : symbols) {
+        Item item{id};
+        head.u32(item.isTerminal() ? 0 : 1);
+        head.text(item.getName());
+    }
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(head.data().data(), static_cast<std::streamsize>(head.data().size()));
+    out.write(body.data().data(), static_cast<std::streamsize>(body.data().size()));
+    if (!out) {
+        throw runtime_error("can not write state file " + path);
+    }
+}
+
+vector<HandlerSet> TableCache::readStates(const Context &context, const string &path) const {
+    std::ifstream in{path, std::ios::binary};
+    if (!in) {
+        throw runtime_error("can not open state file " + path);
+    }
+    Reader reader{vector<char>{std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}}};
+    auto &rules = context.getRules();
+    if (reader.u32() != magic || reader.u32() != version || reader.u32() != byteOrderMark ||
+        reader.u32() != rules.size()) {
+        throw runtime_error("invalid state file " + path);
+    }
+    // the symbol ids of this process
+    vector<Item> symbols{};
+    auto symbolCount = reader.count(2 * sizeof(uint32_t));
+    // every state has at least its shift symbol, parent, handler and transition count
+    auto stateCount = reader.count(4 * sizeof(uint32_t));
+    symbols.reserve(symbolCount);
+    for (uint32_t i = 0; i < symbolCount; i++) {
+        auto type = reader.u32() == 0 ? ItemType::Terminal : ItemType::NoTerminal;
+        symbols.emplace_back(reader.text(), type);
+    }
+    auto symbol = [&symbols, &path](uint32_t index) -> const Item & {
+        if (index >= symbols.size()) {
+            throw runtime_error("invalid state file " + path);
+        }
+        return symbols[index];
+    };
+
+    auto &productions = ProductionTable::global();
+    vector<const Production *> shared{};
+    shared.reserve(rules.size());
+    for (auto &rule : rules) {
+        shared.push_back(&productions.intern(rule));
+    }
+    vector<HandlerSet> result{};
+    result.reserve(stateCount);
+    vector<Item> looks{};
+    for (uint32_t i = 0; i < stateCount; i++) {
+        auto &shift = symbol(reader.u32());
+        auto parent = static_cast<int>(reader.u32());
+        auto handlerCount = reader.count(3 * sizeof(uint32_t));
+        vector<Handler> handlers{};
+        handlers.reserve(handlerCount);
+        for (uint32_t j = 0; j < handlerCount; j++) {
+            auto rule = reader.u32();
+            auto position = reader.u32();
+            if (rule >= shared.size() || position > shared[rule]->size()) {
+                throw runtime_error("invalid state file " + path);
+            }
+            looks.clear();
+            auto lookCount = reader.count(sizeof(uint32_t));
+            for (uint32_t k = 0; k < lookCount; k++) {
+                looks.push_back(symbol(reader.u32()));
+            }
+            // the ids of this process may order the set another way
+            std::sort(looks.begin(), looks.end());
+            handlers.push_back(Handler::shared(*shared[rule], position, LookForward::intern(looks)));
+        }
+        result.emplace_back(shift, std::move(handlers));
+        auto &state = result.back();
+        state.setId(static_cast<int>(i));
+        state.setParentId(parent);
+        auto transitionCount = reader.count(2 * sizeof(uint32_t));
+        state.reserveTransitions(transitionCount);
+        for (uint32_t j = 0; j < transitionCount; j++) {
+            auto &next = symbol(reader.u32());
+            auto target = reader.u32();
+            if (target >= stateCount) {
+                throw runtime_error("invalid state file " + path);
+            }
+            state.addTransition(next, static_cast<int>(target));
+        }
+    }
+    if (!reader.end()) {
+        throw runtime_error("invalid state file " + path);
+    }
+    return result;
+}
@@ -0,0 +1,69 @@
+#ifndef TABLE_CACHE_H
+#define TABLE_CACHE_H
+
+#include "Context.h"
+#include "TableFile.h"
+#include <memory>
+#include <string>
+
+// the automaton a Context generates
+enum class GenerationMode : uint8_t {
+    Lr1,
+    Lalr1,
+    MinimalLr1,
+};
+
+// content addressed cache of generated automata and tables in a local directory. an entry is named by a hash of
+// the productions in order, the start production, the generation mode and the precedence declarations, so equal
+// grammars share it across processes and an edited grammar never finds a stale one:
+//   <key>.lr1t  the table, a TableFile used in place through mmap
+//   <key>.lr1s  the states with their handlers and transitions
+// both files are written under a temporary name and renamed into place, so of concurrent writers of one entry
+// the last rename wins and a reader only ever sees complete files.
+class TableCache {
+public:
+    static constexpr uint32_t magic = 0x5331524c;   // "LR1S"
+    static constexpr uint32_t version = 1;
+
+    // creates directory if it does not exist
+    explicit TableCache(std::string directory);
+
+    // 32 hex digits
+    static std::string key(const Context &context, GenerationMode mode);
+
+    // the mapped table of context, generated and stored on a miss
+    std::unique_ptr<TableFile> table(Context &context, GenerationMode mode = GenerationMode::Lr1);
+
+    // the states of context, generated and stored on a miss
+    std::vector<HandlerSet> states(Context &context, GenerationMode mode = GenerationMode::Lr1);
+
+    const std::string &directory() const {
+        return root;
+    }
+
+    // the lookups which found a valid file and the ones which generated it
+    size_t hits() const {
+        return hitCount;
+    }
+
+    size_t misses() const {
+        return missCount;
+    }
+
+private:
+    std::string path(const std::string &key, const char *extension) const;
+
+    // generates the states and the table of context and stores both under key
+    std::vector<HandlerSet> generate(Context &context, GenerationMode mode, const std::string &key);
+
+    void writeStates(const Context &context, const std::vector<HandlerSet> &states, const std::string &path) const;
+
+    // throws if the file is missing or no state file of this version and grammar
+    std::vector<HandlerSet> readStates(const Context &context, const std::string &path) const;
+
+    std::string root;
+    size_t hitCount = 0;
+    size_t missCount = 0;
+};
+
+#endif
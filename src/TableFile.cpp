@@ -0,0 +1,192 @@
+#include "TableFile.h"
+#include "SymbolTable.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using std::string;
+using std::vector;
+using std::runtime_error;
+
+static constexpr uint32_t byteOrderMark = 0x01020304;
+
+static uint64_t align8(uint64_t offset) {
+    return (offset + 7) & ~uint64_t{7};
+}
+
+// the parser indexes with the cells, so every shift target, production, goto and default has to be in range
+static bool validCells(const char *base, const TableFile::Header &h) {
+    auto actions = reinterpret_cast<const int32_t *>(base + h.actionOffset);
+    auto gotos = reinterpret_cast<const int32_t *>(base + h.gotoOffset);
+    auto productions = reinterpret_cast<const int32_t *>(base + h.productionOffset);
+    auto defaults = reinterpret_cast<const int32_t *>(base + h.defaultOffset);
+    int64_t states = h.states;
+    int64_t productionCount = h.productions;
+    for (uint64_t i = 0; i < uint64_t{h.states} * h.terminals; i++) {
+        auto action = ParseTable::decode(actions[i]);
+        if ((action.type == ActionType::Shift && (action.value < 0 || action.value >= states)) ||
+            (action.type == ActionType::Reduce && (action.value < 0 || action.value >= productionCount))) {
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < uint64_t{h.states} * h.noTerminals; i++) {
+        if (gotos[i] < -1 || gotos[i] >= states) {
+            return false;
+        }
+    }
+    for (uint64_t p = 0; p < h.productions; p++) {
+        if (productions[p * 2] < 0 || static_cast<uint32_t>(productions[p * 2]) >= h.noTerminals ||
+            productions[p * 2 + 1] < 0) {
+            return false;
+        }
+    }
+    for (uint64_t state = 0; state < h.states; state++) {
+        if (defaults[state] < -1 || defaults[state] >= productionCount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void TableFile::write(const ParseTable &table, int eofSymbol, const string &path) {
+    auto &symbols = SymbolTable::global();
+    vector<int> named{table.terminals()};
+    named.insert(named.end(), table.noTerminals().begin(), table.noTerminals().end());
+    vector<uint32_t> nameIndex{};
+    string names{};
+    for (auto symbol : named) {
+        nameIndex.push_back(static_cast<uint32_t>(names.size()));
+        names += symbols.name(symbol);
+        names.push_back('\0');
+    }
+
+    Header header{};
+    header.magic = magic;
+    header.version = version;
+    header.byteOrder = byteOrderMark;
+    header.states = static_cast<uint32_t>(table.stateCount());
+    header.terminals = static_cast<uint32_t>(table.terminalCount());
+    header.noTerminals = static_cast<uint32_t>(table.noTerminalCount());
+    header.productions = static_cast<uint32_t>(table.productionCount());
+    header.eofColumn = table.terminalColumn(eofSymbol);
+    if (header.eofColumn == -1) {
+        throw runtime_error("unknown end of input symbol");
+    }
+    header.nameIndexOffset = align8(sizeof(Header));
+    header.nameOffset = align8(header.nameIndexOffset + nameIndex.size() * sizeof(uint32_t));
+    header.actionOffset = align8(header.nameOffset + names.size());
+    header.gotoOffset = align8(header.actionOffset + table.actionData().size() * sizeof(int32_t));
+    header.productionOffset = align8(header.gotoOffset + table.gotoData().size() * sizeof(int32_t));
+    header.defaultOffset = align8(header.productionOffset + table.productionData().size() * sizeof(int32_t));
+    header.size = align8(header.defaultOffset + table.defaultData().size() * sizeof(int32_t));
+
+    vector<char> buffer(header.size, 0);
+    auto put = [&buffer](uint64_t offset, const void *data, size_t bytes) {
+        if (bytes != 0) {
+            std::memcpy(buffer.data() + offset, data, bytes);
+        }
+    };
+    put(0, &header, sizeof(Header));
+    put(header.nameIndexOffset, nameIndex.data(), nameIndex.size() * sizeof(uint32_t));
+    put(header.nameOffset, names.data(), names.size());
+    put(header.actionOffset, table.actionData().data(), table.actionData().size() * sizeof(int32_t));
+    put(header.gotoOffset, table.gotoData().data(), table.gotoData().size() * sizeof(int32_t));
+    put(header.productionOffset, table.productionData().data(), table.productionData().size() * sizeof(int32_t));
+    put(header.defaultOffset, table.defaultData().data(), table.defaultData().size() * sizeof(int32_t));
+
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    out.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!out) {
+        throw runtime_error("can not write table file " + path);
+    }
+}
+
+TableFile::TableFile(const string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw runtime_error("can not open table file " + path);
+    }
+    struct stat status{};
+    if (::fstat(fd, &status) == -1 || static_cast<size_t>(status.st_size) < sizeof(Header)) {
+        ::close(fd);
+        throw runtime_error("invalid table file " + path);
+    }
+    length = static_cast<size_t>(status.st_size);
+    void *mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        throw runtime_error("can not map table file " + path);
+    }
+    base = static_cast<const char *>(mapped);
+
+    auto &h = header();
+    auto within = [this](uint64_t offset, uint64_t bytes) {
+        return offset % 8 == 0 && offset <= length && bytes <= length - offset;
+    };
+    uint64_t columns = uint64_t{h.terminals} + h.noTerminals;
+    bool valid = h.magic == magic && h.version == version && h.byteOrder == byteOrderMark && h.size == length &&
+                 h.eofColumn >= 0 && static_cast<uint32_t>(h.eofColumn) < h.terminals &&
+                 within(h.nameIndexOffset, columns * sizeof(uint32_t)) &&
+                 within(h.nameOffset, 0) && h.nameOffset <= h.actionOffset &&
+                 within(h.actionOffset, uint64_t{h.states} * h.terminals * sizeof(int32_t)) &&
+                 within(h.gotoOffset, uint64_t{h.states} * h.noTerminals * sizeof(int32_t)) &&
+                 within(h.productionOffset, uint64_t{h.productions} * 2 * sizeof(int32_t)) &&
+                 within(h.defaultOffset, uint64_t{h.states} * sizeof(int32_t));
+    if (valid) {
+        // every name has to end inside the name section
+        auto index = reinterpret_cast<const uint32_t *>(base + h.nameIndexOffset);
+        auto nameBytes = h.actionOffset - h.nameOffset;
+        for (uint64_t i = 0; i < columns && valid; i++) {
+            valid = index[i] < nameBytes && std::memchr(base + h.nameOffset + index[i], '\0',
+                                                        nameBytes - index[i]) != nullptr;
+        }
+    }
+    valid = valid && validCells(base, h);
+    if (!valid) {
+        ::munmap(mapped, length);
+        base = nullptr;
+        throw runtime_error("invalid table file " + path);
+    }
+
+    auto &symbols = SymbolTable::global();
+    for (uint32_t column = 0; column < h.terminals; column++) {
+        int symbol = symbols.intern(terminalName(static_cast<int>(column)), ItemType::Terminal);
+        if (static_cast<size_t>(symbol) >= terminalColumns.size()) {
+            terminalColumns.resize(symbol + 1, -1);
+        }
+        terminalColumns[symbol] = static_cast<int32_t>(column);
+    }
+    eof = symbols.intern(terminalName(h.eofColumn), ItemType::Terminal);
+}
+
+TableFile::~TableFile() {
+    if (base != nullptr) {
+        ::munmap(const_cast<char *>(base), length);
+    }
+}
+
+ParseTableView TableFile::view() const {
+    auto &h = header();
+    return ParseTableView{reinterpret_cast<const int32_t *>(base + h.actionOffset),
+                          reinterpret_cast<const int32_t *>(base + h.gotoOffset),
+                          reinterpret_cast<const int32_t *>(base + h.productionOffset),
+                          reinterpret_cast<const int32_t *>(base + h.defaultOffset),
+                          terminalColumns.data(), h.states, h.terminals, h.noTerminals, h.productions,
+                          terminalColumns.size()};
+}
+
+const char *TableFile::terminalName(int column) const {
+    auto &h = header();
+    auto index = reinterpret_cast<const uint32_t *>(base + h.nameIndexOffset);
+    return base + h.nameOffset + index[column];
+}
+
+const char *TableFile::noTerminalName(int column) const {
+    auto &h = header();
+    auto index = reinterpret_cast<const uint32_t *>(base + h.nameIndexOffset);
+    return base + h.nameOffset + index[h.terminals + column];
+}
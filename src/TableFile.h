@@ -0,0 +1,73 @@
+#ifndef TABLE_FILE_H
+#define TABLE_FILE_H
+
+#include "ParseTable.h"
+#include <string>
+
+// binary table file, used in place through mmap.
+// every section starts on an 8 byte boundary, all integers are in the byte order of the writer:
+//   Header
+//   uint32 name offsets, the terminal columns then the no terminal columns
+//   the names, each terminated by '\0'
+//   int32 action cells [states][terminals]
+//   int32 goto cells [states][no terminals]
+//   int32 (no terminal column, length) of every production
+//   int32 default reduction of every state, -1 for none
+// symbol ids only exist within one process, a loaded file maps the names to the local ids again.
+class TableFile {
+public:
+    static constexpr uint32_t magic = 0x5431524c;   // "LR1T"
+    static constexpr uint32_t version = 2;
+
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t byteOrder;
+        uint32_t states;
+        uint32_t terminals;
+        uint32_t noTerminals;
+        uint32_t productions;
+        int32_t eofColumn;
+        uint64_t nameIndexOffset;
+        uint64_t nameOffset;
+        uint64_t actionOffset;
+        uint64_t gotoOffset;
+        uint64_t productionOffset;
+        uint64_t defaultOffset;
+        uint64_t size;
+    };
+
+    static void write(const ParseTable &table, int eofSymbol, const std::string &path);
+
+    // maps the file, throws if it is not a table file of this version or a cell points out of the table
+    explicit TableFile(const std::string &path);
+
+    ~TableFile();
+
+    TableFile(const TableFile &) = delete;
+
+    TableFile &operator=(const TableFile &) = delete;
+
+    ParseTableView view() const;
+
+    const Header &header() const {
+        return *reinterpret_cast<const Header *>(base);
+    }
+
+    const char *terminalName(int column) const;
+
+    const char *noTerminalName(int column) const;
+
+    // the local symbol id of the end of input terminal
+    int eofSymbol() const {
+        return eof;
+    }
+
+private:
+    const char *base = nullptr;
+    size_t length = 0;
+    int eof = -1;
+    std::vector<int32_t> terminalColumns;
+};
+
+#endif
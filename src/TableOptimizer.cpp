@@ -0,0 +1,181 @@
+#include "TableOptimizer.h"
+#include <map>
+
+using std::vector;
+
+TableOptimizer::TableOptimizer(ParseTable &tableRef) : table(tableRef) {
+
+}
+
+TableSavings TableOptimizer::addDefaultReductions() {
+    TableSavings savings{table.footprint(), {}, table.stateCount(), 0, 0, 0, 0, 0};
+    auto terminals = static_cast<int>(table.terminalCount());
+    std::map<int, size_t> reduces{};
+    for (int state = 0; state < static_cast<int>(table.stateCount()); state++) {
+        if (table.hasExplicitError(state) || table.defaultReduction(state) != -1) {
+            continue;
+        }
+        reduces.clear();
+        bool accepts = false;
+        for (int column = 0; column < terminals; column++) {
+            auto action = table.action(state, column);
+            accepts = accepts || action.type == ActionType::Accept;
+            if (action.type == ActionType::Reduce) {
+                reduces[action.value]++;
+            }
+        }
+        if (accepts || reduces.empty()) {
+            continue;
+        }
+        // the map is ordered by production, a later production has to reduce on more terminals to win
+        auto chosen = reduces.begin();
+        for (auto ptr = reduces.begin(); ptr != reduces.end(); ++ptr) {
+            if (ptr->second > chosen->second) {
+                chosen = ptr;
+            }
+        }
+        int production = chosen->first;
+        for (int column = 0; column < terminals; column++) {
+            if (table.action(state, column) == ParseAction{ActionType::Reduce, production}) {
+                table.putAction(state, column, ParseAction{ActionType::Error, 0});
+            }
+        }
+        table.setDefaultReduction(state, production);
+        savings.defaultReductions++;
+        savings.replacedReduces += chosen->second;
+    }
+    savings.after = table.footprint();
+    savings.statesAfter = table.stateCount();
+    return savings;
+}
+
+int TableOptimizer::unitReduction(int state, const vector<char> &kept) const {
+    // an empty cell of a %nonassoc state is an error, bypassing the state would reduce there
+    if (table.hasExplicitError(state)) {
+        return -1;
+    }
+    int production = table.defaultReduction(state);
+    for (int column = 0; column < static_cast<int>(table.terminalCount()); column++) {
+        auto action = table.action(state, column);
+        if (action.type == ActionType::Error) {
+            continue;
+        }
+        if (action.type != ActionType::Reduce || (production != -1 && action.value != production)) {
+            return -1;
+        }
+        production = action.value;
+    }
+    if (production == -1 || table.reduceLength(production) != 1 || kept[production]) {
+        return -1;
+    }
+    return production;
+}
+
+TableSavings TableOptimizer::eliminateUnitRules(const vector<int> &keep) {
+    TableSavings savings{table.footprint(), {}, table.stateCount(), 0, 0, 0, 0, 0};
+    vector<char> kept(table.productionCount(), 0);
+    for (auto production : keep) {
+        if (production >= 0 && static_cast<size_t>(production) < kept.size()) {
+            kept[production] = 1;
+        }
+    }
+    // a state reached by a goto on B holds B on top of the stack, a reduce of length 1 there is one by A -> B
+    vector<int> units(table.stateCount(), -1);
+    for (int state = 0; state < static_cast<int>(table.stateCount()); state++) {
+        units[state] = unitReduction(state, kept);
+    }
+    // the chains are followed through the gotos as they were, the new ones are written afterwards
+    auto noTerminals = static_cast<int>(table.noTerminalCount());
+    vector<int> gotos(table.gotoData().begin(), table.gotoData().end());
+    for (int state = 0; state < static_cast<int>(table.stateCount()); state++) {
+        for (int column = 0; column < noTerminals; column++) {
+            int next = table.goTo(state, column);
+            size_t chain = 0;
+            // a cycle of unit productions makes the grammar ambiguous, the bound keeps it from looping here
+            while (next != -1 && units[next] != -1 && chain < static_cast<size_t>(noTerminals)) {
+                int target = table.goTo(state, table.reduceColumn(units[next]));
+                if (target == -1) {
+                    break;
+                }
+                next = target;
+                chain++;
+            }
+            if (chain != 0) {
+                gotos[state * noTerminals + column] = next;
+                savings.bypassedGotos++;
+                savings.bypassedReductions += chain;
+            }
+        }
+    }
+    for (int state = 0; state < static_cast<int>(table.stateCount()); state++) {
+        for (int column = 0; column < noTerminals; column++) {
+            table.setGoto(state, column, gotos[state * noTerminals + column]);
+        }
+    }
+    savings.statesAfter = dropUnreachable();
+    savings.after = table.footprint();
+    return savings;
+}
+
+size_t TableOptimizer::dropUnreachable() {
+    auto states = static_cast<int>(table.stateCount());
+    auto terminals = static_cast<int>(table.terminalCount());
+    auto noTerminals = static_cast<int>(table.noTerminalCount());
+    vector<int> renumber(states, -1);
+    vector<int> worklist{0};
+    renumber[0] = 0;
+    auto reach = [&renumber, &worklist](int state) {
+        if (state != -1 && renumber[state] == -1) {
+            renumber[state] = 0;
+            worklist.push_back(state);
+        }
+    };
+    while (!worklist.empty()) {
+        int state = worklist.back();
+        worklist.pop_back();
+        for (int column = 0; column < terminals; column++) {
+            auto action = table.action(state, column);
+            if (action.type == ActionType::Shift) {
+                reach(action.value);
+            }
+        }
+        for (int column = 0; column < noTerminals; column++) {
+            reach(table.goTo(state, column));
+        }
+    }
+    // the states left keep their order, state 0 stays the start state
+    int count = 0;
+    for (auto &id : renumber) {
+        id = id == -1 ? -1 : count++;
+    }
+    if (count == states) {
+        return table.stateCount();
+    }
+    ParseTable result{static_cast<size_t>(count), table.terminals(), table.noTerminals()};
+    for (int p = 0; p < static_cast<int>(table.productionCount()); p++) {
+        result.setProduction(p, table.reduceColumn(p), table.reduceLength(p));
+    }
+    for (int state = 0; state < states; state++) {
+        int row = renumber[state];
+        if (row == -1) {
+            continue;
+        }
+        for (int column = 0; column < terminals; column++) {
+            auto action = table.action(state, column);
+            if (action.type == ActionType::Shift) {
+                action.value = renumber[action.value];
+            }
+            result.putAction(row, column, action);
+        }
+        for (int column = 0; column < noTerminals; column++) {
+            int next = table.goTo(state, column);
+            result.setGoto(row, column, next == -1 ? -1 : renumber[next]);
+        }
+        result.setDefaultReduction(row, table.defaultReduction(state));
+        if (table.hasExplicitError(state)) {
+            result.markExplicitError(row);
+        }
+    }
+    table = std::move(result);
+    return table.stateCount();
+}
@@ -0,0 +1,49 @@
+#ifndef TABLE_OPTIMIZER_H
+#define TABLE_OPTIMIZER_H
+
+#include "ParseTable.h"
+#include <vector>
+
+// what a pass of TableOptimizer changed
+struct TableSavings {
+    ParseTable::Footprint before;
+    ParseTable::Footprint after;
+    size_t statesBefore;
+    size_t statesAfter;
+    // the states given a default reduction and the reduce cells it took the place of
+    size_t defaultReductions;
+    size_t replacedReduces;
+    // the goto cells leading past a chain of unit reductions now and the reductions of those chains,
+    // every time the parser takes such a goto it does that many reductions less
+    size_t bypassedGotos;
+    size_t bypassedReductions;
+};
+
+// rewrites the ParseTable of Context::table(), LrParser, TableFile and DirectCodeGenerator run the result.
+// both passes may find an error in a later state than before, but never after shifting the erroneous token.
+class TableOptimizer {
+public:
+    explicit TableOptimizer(ParseTable &table);
+
+    // gives every state a default reduction by the production it reduces on the most terminals, the lower one on
+    // a tie. the reduce cells of that production are emptied and every empty cell of the state reduces by it.
+    // states with an accept or a %nonassoc error cell keep their rows
+    TableSavings addDefaultReductions();
+
+    // a state reached by goto(p, B) which reduces by a unit production A -> B and does nothing else is bypassed:
+    // goto(p, B) leads to goto(p, A) instead, along the whole chain, and the states no shift or goto reaches any
+    // more are dropped. states with a %nonassoc error cell are not bypassed. the productions in keep have a
+    // semantic action and are always reduced
+    TableSavings eliminateUnitRules(const std::vector<int> &keep = {});
+
+private:
+    // the unit production state reduces by and nothing else, -1 if there is none
+    int unitReduction(int state, const std::vector<char> &kept) const;
+
+    // drops the states state 0 reaches by no shift or goto, returns how many are left
+    size_t dropUnreachable();
+
+    ParseTable &table;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+using std::pair;
+using std::mutex;
+using std::lock_guard;
+using std::unique_lock;
+
+ThreadPool::ThreadPool(size_t threadCount) : workerCount{threadCount} {
+    if (workerCount == 0) {
+        workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < workerCount; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    // a single worker runs the loops on the calling thread
+    if (workerCount > 1) {
+        for (size_t i = 0; i < workerCount; i++) {
+            threads.emplace_back([this, i] { run(i); });
+        }
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock{poolMutex};
+        stop = true;
+    }
+    wake.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t, size_t)> &task) {
+    if (count == 0) {
+        return;
+    }
+    if (threads.empty()) {
+        for (size_t i = 0; i < count; i++) {
+            task(i, 0);
+        }
+        return;
+    }
+    // a few ranges per worker, small enough to balance by stealing
+    size_t chunk = std::max<size_t>(1, count / (workerCount * 8));
+    size_t ranges = (count + chunk - 1) / chunk;
+    {
+        lock_guard<mutex> lock{poolMutex};
+        current = &task;
+        failure = nullptr;
+        pending = ranges;
+        for (size_t r = 0; r < ranges; r++) {
+            auto &queue = *queues[r % workerCount];
+            lock_guard<mutex> queueLock{queue.mutex};
+            queue.ranges.emplace_back(r * chunk, std::min(count, (r + 1) * chunk));
+        }
+        generation++;
+    }
+    wake.notify_all();
+    unique_lock<mutex> lock{poolMutex};
+    done.wait(lock, [this] { return pending == 0; });
+    current = nullptr;
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+void ThreadPool::run(size_t worker) {
+    size_t seen = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock{poolMutex};
+            wake.wait(lock, [this, &seen] { return stop || generation != seen; });
+            if (stop) {
+                return;
+            }
+            seen = generation;
+        }
+        pair<size_t, size_t> range{};
+        while (take(worker, range)) {
+            // a range is only queued while its loop runs, so current still belongs to it
+            const std::function<void(size_t, size_t)> *task;
+            {
+                lock_guard<mutex> lock{poolMutex};
+                task = current;
+            }
+            try {
+                for (size_t i = range.first; i < range.second; i++) {
+                    (*task)(i, worker);
+                }
+            } catch (...) {
+                lock_guard<mutex> lock{poolMutex};
+                if (!failure) {
+                    failure = std::current_exception();
+                }
+            }
+            lock_guard<mutex> lock{poolMutex};
+            if (--pending == 0) {
+                done.notify_all();
+            }
+        }
+    }
+}
+
+bool ThreadPool::take(size_t worker, pair<size_t, size_t> &range) {
+    {
+        auto &own = *queues[worker];
+        lock_guard<mutex> lock{own.mutex};
+        if (!own.ranges.empty()) {
+            range = own.ranges.back();
+            own.ranges.pop_back();
+            return true;
+        }
+    }
+    for (size_t i = 1; i < workerCount; i++) {
+        auto &other = *queues[(worker + i) % workerCount];
+        lock_guard<mutex> lock{other.mutex};
+        if (!other.ranges.empty()) {
+            range = other.ranges.front();
+            other.ranges.pop_front();
+            stealCount++;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,67 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// fixed set of workers for data parallel loops.
+// every worker owns a queue of index ranges, it takes work from the back of its own queue and
+// steals from the front of the others once it runs dry.
+class ThreadPool {
+public:
+    // 0 uses one worker per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t size() const {
+        return workerCount;
+    }
+
+    // runs task(index, worker) for every index in [0, count) and returns when all of them are done.
+    // worker is in [0, size()), the first exception thrown by a task is rethrown here
+    void parallelFor(size_t count, const std::function<void(size_t, size_t)> &task);
+
+    // how many ranges were taken from the queue of another worker
+    size_t steals() const {
+        return stealCount;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<std::pair<size_t, size_t>> ranges;
+    };
+
+    void run(size_t worker);
+
+    bool take(size_t worker, std::pair<size_t, size_t> &range);
+
+    size_t workerCount;
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::mutex poolMutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t, size_t)> *current = nullptr;
+    std::exception_ptr failure;
+    size_t generation = 0;
+    size_t pending = 0;
+    std::atomic<size_t> stealCount{0};
+    bool stop = false;
+};
+
+#endif
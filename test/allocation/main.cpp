@@ -0,0 +1,88 @@
+#include <gmock/gmock.h>
+#include "../../src/Context.h"
+#include "../../src/GrammarFile.h"
+#include "../lua/LuaGrammar.h"
+
+using namespace std;
+using namespace testing;
+
+// counts the calls of operator new from its construction on, through the counting operator new of Statistics
+class Allocations {
+public:
+    size_t count() const {
+        return Statistics::allocations() - begin;
+    }
+
+private:
+    size_t begin = Statistics::allocations();
+};
+
+#define REQUIRE_HEAP_COUNTING() \
+    if (!Statistics::countsHeap()) { \
+        GTEST_SKIP() << "linked without the counting operator new"; \
+    }
+
+// the allocations of generalLr1() for every state it generates
+static double allocationsPerState(Context &context) {
+    context.first();
+    Allocations allocations{};
+    auto states = context.generalLr1();
+    return static_cast<double>(allocations.count()) / static_cast<double>(states.size());
+}
+
+TEST(Allocation, CopyingHandlersAndLookForwardSetsShouldNotAllocate) {
+    REQUIRE_HEAP_COUNTING();
+    Production production{Item{"E", ItemType::NoTerminal}, {Item{"E", ItemType::NoTerminal},
+                                                            Item{"+", ItemType::Terminal},
+                                                            Item{"i", ItemType::Terminal}}};
+    Handler handler{production, 0, set<Item>{Item{"$", ItemType::Terminal}}};
+    BitSet bits{100};
+    bits.set(99);
+    Allocations allocations{};
+    auto copy = handler;
+    auto next = copy.nextHandler().nextHandler();
+    auto bitsCopy = bits;
+    auto moved = std::move(bitsCopy);
+    EXPECT_EQ(allocations.count(), 0);
+    EXPECT_EQ(next.getPosition(), 2);
+    EXPECT_TRUE(moved.test(99));
+}
+
+TEST(Allocation, GotoOfAClosedStateShouldOnlyAllocateItsResult) {
+    REQUIRE_HEAP_COUNTING();
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    auto states = context.generalLr1();
+    // every closure is cached now, a goto only builds the successor states it returns
+    for (auto &state : states) {
+        Allocations allocations{};
+        auto next = context.Goto(state);
+        ASSERT_LE(allocations.count(), 1 + next.size()) << "state " << state.getId();
+        ASSERT_EQ(next.size(), state.transitionList().size());
+    }
+}
+
+TEST(Allocation, GeneratingShouldAllocateAFixedNumberOfTimesPerState) {
+    REQUIRE_HEAP_COUNTING();
+    LuaGrammar lua{};
+    {
+        Context cached{lua.productionList, lua.productionList[0]};
+        EXPECT_LE(allocationsPerState(cached), 16);
+    }
+
+    // the first context is gone with its intern pool, this one interns every look forward set again
+    Context uncached{lua.productionList, lua.productionList[0]};
+    uncached.setClosureCacheLimit(0);
+    EXPECT_LE(allocationsPerState(uncached), 20);
+
+    auto expression = GrammarFile::parse("S ::= E\n"
+                                         "E ::= E + T | E - T | T\n"
+                                         "T ::= T * F | T / F | F\n"
+                                         "F ::= ( E ) | - F | i\n").context();
+    EXPECT_LE(allocationsPerState(expression), 16);
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
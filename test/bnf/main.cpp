@@ -0,0 +1,129 @@
+#include <gmock/gmock.h>
+#include "../../src/GrammarFile.h"
+#include "../../src/LrParser.h"
+#include "../lua/LuaGrammar.h"
+#include <chrono>
+#include <fstream>
+
+using namespace std;
+using namespace testing;
+
+TEST(GrammarFile, ShouldBuildTheProductionsOfTheRules) {
+    auto grammar = GrammarFile::parse("S_ ::= S\n"
+                                      "S ::= C C\n"
+                                      "C ::= c C | d // the last one\n");
+    Item S_{"S_", ItemType::NoTerminal};
+    Item S{"S", ItemType::NoTerminal};
+    Item C{"C", ItemType::NoTerminal};
+    Item c{"c", ItemType::Terminal};
+    Item d{"d", ItemType::Terminal};
+    EXPECT_EQ(grammar.productions(), (vector<Production>{
+            Production{S_, vector<Item>{S}},
+            Production{S, vector<Item>{C, C}},
+            Production{C, vector<Item>{c, C}},
+            Production{C, vector<Item>{d}},
+    }));
+    EXPECT_EQ(grammar.noTerminalCount(), 3);
+    EXPECT_EQ(grammar.terminalCount(), 2);
+    EXPECT_EQ(grammar.location(3).line, 3);
+    EXPECT_EQ(grammar.location(3).column, 13);
+    auto context = grammar.context();
+    auto states = context.generalLr1();
+    EXPECT_EQ(states.size(), 10);
+}
+
+TEST(GrammarFile, ShouldAddAStartProductionAndReadQuotesAndEpsilon) {
+    auto grammar = GrammarFile::parse("list ::= ε | list `item´ | list 'list' `,` \"|\"\n"
+                                      "list_ ::= list");
+    Item start{"list__", ItemType::NoTerminal};
+    Item list{"list", ItemType::NoTerminal};
+    Item list_{"list_", ItemType::NoTerminal};
+    Item empty{"000", ItemType::Terminal};
+    Item item{"item", ItemType::Terminal};
+    Item quotedList{"list", ItemType::Terminal};
+    Item comma{",", ItemType::Terminal};
+    Item bar{"|", ItemType::Terminal};
+    EXPECT_EQ(grammar.productions(), (vector<Production>{
+            Production{start, vector<Item>{list}},
+            Production{list, vector<Item>{empty}},
+            Production{list, vector<Item>{list, item}},
+            Production{list, vector<Item>{list, quotedList, comma, bar}},
+            Production{list_, vector<Item>{list}},
+    }));
+    EXPECT_EQ(grammar.startProduction(), grammar.productions()[0]);
+    EXPECT_EQ(grammar.noTerminalCount(), 3);
+    EXPECT_EQ(grammar.terminalCount(), 4);
+}
+
+TEST(GrammarFile, ShouldReportWhereTheErrorIs) {
+    auto errorAt = [](const string &text) {
+        try {
+            GrammarFile::parse(text, "test.bnf");
+        } catch (GrammarError &error) {
+            return make_tuple(error.line(), error.column(), string{error.what()});
+        }
+        return make_tuple(size_t{0}, size_t{0}, string{});
+    };
+    EXPECT_EQ(errorAt("S a"), make_tuple(size_t{1}, size_t{3}, string{"test.bnf:1:3: expected ::= after S"}));
+    EXPECT_EQ(get<0>(errorAt("S ::= a |\nT ::= b")), 2);
+    EXPECT_THAT(get<2>(errorAt("S ::= a |\nT ::= b")), HasSubstr("empty alternative"));
+    EXPECT_EQ(errorAt("S ::= a `b\n"), make_tuple(size_t{1}, size_t{9}, string{"test.bnf:1:9: unterminated quoted symbol"}));
+    EXPECT_THAT(get<2>(errorAt("S ::= a ε")), HasSubstr("only symbol"));
+    EXPECT_THAT(get<2>(errorAt("S ::= ε a")), HasSubstr("only symbol"));
+    EXPECT_THAT(get<2>(errorAt("S ::= a ::= b")), HasSubstr("empty alternative"));
+    EXPECT_THAT(get<2>(errorAt("S ::= ::= b")), HasSubstr("empty alternative"));
+    EXPECT_THAT(get<2>(errorAt("| S ::= a")), HasSubstr("rule name"));
+    EXPECT_THAT(get<2>(errorAt("// nothing\n")), HasSubstr("no rules"));
+    EXPECT_THROW(GrammarFile::load(TempDir() + "missing.bnf"), runtime_error);
+}
+
+TEST(GrammarFile, LuaFileShouldMatchLuaGrammar) {
+    LuaGrammar lua{};
+    Context expected{lua.productionList, lua.productionList[0]};
+    auto expectedStates = expected.generateLr1Parallel();
+
+    auto grammar = GrammarFile::load(LUA_BNF);
+    ASSERT_EQ(grammar.productions().size(), lua.productionList.size());
+    auto context = grammar.context();
+    auto states = context.generateLr1Parallel();
+    EXPECT_EQ(states.size(), expectedStates.size());
+    auto table = context.table(states);
+    EXPECT_EQ(table.terminalCount(), expected.table(expectedStates).terminalCount());
+
+    // the terminals share their names, so the tokens of LuaGrammar parse with the loaded table
+    LrParser parser{table, Item{"$", ItemType::Terminal}.getId()};
+    vector<Item> program{lua.local, lua.name, lua.eq, lua.number_,
+                         lua.while_, lua.name, lua.do_, lua.name, lua.eq, lua.string_, lua.end_,
+                         lua.return_, lua.name};
+    vector<int> tokens{};
+    for (auto &item : program) {
+        tokens.push_back(item.getId());
+    }
+    EXPECT_TRUE(parser.parse(tokens).accepted);
+}
+
+TEST(GrammarFile, ShouldLoadLargeGrammars) {
+    auto path = TempDir() + "large.bnf";
+    size_t rules = 5000;
+    {
+        std::ofstream out{path};
+        out << "s ::= r0\n";
+        for (size_t i = 0; i < rules; i++) {
+            out << "r" << i << " ::= t" << i << " r" << (i + 1) % rules << " `;´ | ε | r" << (i * 7 + 3) % rules
+                << " t" << i % 100 << "\n";
+        }
+    }
+    auto begin = chrono::steady_clock::now();
+    auto grammar = GrammarFile::load(path);
+    auto elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - begin).count();
+    ::printf("loaded %zu productions in %.2f ms\n", grammar.productions().size(), elapsed);
+    EXPECT_EQ(grammar.productions().size(), rules * 3 + 1);
+    EXPECT_EQ(grammar.noTerminalCount(), rules + 1);
+    EXPECT_EQ(grammar.terminalCount(), rules + 1);
+    EXPECT_EQ(grammar.location(rules * 3).line, rules + 1);
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
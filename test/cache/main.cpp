@@ -0,0 +1,161 @@
+#include <gmock/gmock.h>
+#include "../../src/TableCache.h"
+#include "../../src/GrammarFile.h"
+#include "../lua/ExpressionGrammar.h"
+#include "../lua/LuaGrammar.h"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+using namespace std;
+using namespace testing;
+
+class Cache : public Test {
+protected:
+    // a directory of its own for every test, removed again afterwards
+    string directory = TempDir() + "lr1-cache-" + to_string(::getpid()) + "-" +
+                       UnitTest::GetInstance()->current_test_info()->name();
+
+    void TearDown() override {
+        filesystem::remove_all(directory);
+    }
+
+    size_t files() const {
+        return static_cast<size_t>(distance(filesystem::directory_iterator{directory},
+                                            filesystem::directory_iterator{}));
+    }
+};
+
+static void expectSameStates(const vector<HandlerSet> &loaded, const vector<HandlerSet> &generated) {
+    ASSERT_EQ(loaded.size(), generated.size());
+    for (size_t i = 0; i < generated.size(); i++) {
+        ASSERT_EQ(loaded[i].ruleList(), generated[i].ruleList()) << "state " << i;
+        ASSERT_EQ(loaded[i].transitionList(), generated[i].transitionList()) << "state " << i;
+        ASSERT_EQ(loaded[i].shiftItem(), generated[i].shiftItem()) << "state " << i;
+        ASSERT_EQ(loaded[i].getParentId(), generated[i].getParentId()) << "state " << i;
+    }
+}
+
+TEST_F(Cache, ShouldGenerateOnAMissAndMapOnAHit) {
+    LuaGrammar lua{};
+    Context generating{lua.productionList, lua.productionList[0]};
+    auto states = generating.generalLr1();
+    auto expected = generating.table(states);
+
+    TableCache cache{directory};
+    Context missing{lua.productionList, lua.productionList[0]};
+    auto table = cache.table(missing);
+    EXPECT_EQ(cache.misses(), 1);
+    EXPECT_EQ(files(), 2);
+
+    // another cache over the directory, as the next process would open it
+    TableCache reopened{directory};
+    Context hitting{lua.productionList, lua.productionList[0]};
+    auto mapped = reopened.table(hitting);
+    auto loaded = reopened.states(hitting);
+    EXPECT_EQ(reopened.hits(), 2);
+    EXPECT_EQ(reopened.misses(), 0);
+    for (auto file : {table.get(), mapped.get()}) {
+        auto view = file->view();
+        ASSERT_EQ(view.states, expected.stateCount());
+        EXPECT_EQ(0, memcmp(view.actions, expected.actionData().data(),
+                            expected.actionData().size() * sizeof(int32_t)));
+        EXPECT_EQ(0, memcmp(view.gotos, expected.gotoData().data(), expected.gotoData().size() * sizeof(int32_t)));
+    }
+    expectSameStates(loaded, states);
+}
+
+TEST_F(Cache, KeyShouldCoverTheGrammarTheModeAndThePrecedence) {
+    auto base = TableCache::key(GrammarFile::parse(expression).context(), GenerationMode::Lr1);
+    EXPECT_EQ(base.size(), 32);
+    EXPECT_EQ(base, TableCache::key(GrammarFile::parse(expression).context(), GenerationMode::Lr1));
+    EXPECT_NE(base, TableCache::key(GrammarFile::parse(expression).context(), GenerationMode::Lalr1));
+    EXPECT_NE(base, TableCache::key(GrammarFile::parse(expression).context(), GenerationMode::MinimalLr1));
+    EXPECT_NE(base, TableCache::key(GrammarFile::parse(string{expression} + "F ::= - F\n").context(),
+                                    GenerationMode::Lr1));
+    // the same rules in another order number the productions another way
+    EXPECT_NE(base, TableCache::key(GrammarFile::parse("S ::= E\n"
+                                                       "E ::= T | E + T\n"
+                                                       "T ::= T * F | F\n"
+                                                       "F ::= ( E ) | i\n").context(), GenerationMode::Lr1));
+
+    auto ambiguous = "E ::= E + E | E * E | i\n";
+    auto plain = TableCache::key(GrammarFile::parse(ambiguous).context(), GenerationMode::Lr1);
+    auto left = TableCache::key(GrammarFile::parse(string{"%left +\n%left *\n"} + ambiguous).context(),
+                                GenerationMode::Lr1);
+    auto right = TableCache::key(GrammarFile::parse(string{"%left +\n%right *\n"} + ambiguous).context(),
+                                 GenerationMode::Lr1);
+    EXPECT_NE(plain, left);
+    EXPECT_NE(left, right);
+}
+
+TEST_F(Cache, EveryModeShouldBeCachedApart) {
+    TableCache cache{directory};
+    for (auto mode : {GenerationMode::Lr1, GenerationMode::Lalr1, GenerationMode::MinimalLr1}) {
+        auto context = GrammarFile::parse(expression).context();
+        auto generated = cache.states(context, mode);
+        auto again = GrammarFile::parse(expression).context();
+        expectSameStates(cache.states(again, mode), generated);
+    }
+    EXPECT_EQ(cache.misses(), 3);
+    EXPECT_EQ(cache.hits(), 3);
+    EXPECT_EQ(files(), 6);
+}
+
+TEST_F(Cache, DamagedFilesShouldBeGeneratedAgain) {
+    TableCache cache{directory};
+    auto context = GrammarFile::parse(expression).context();
+    auto states = cache.states(context);
+    auto key = TableCache::key(context, GenerationMode::Lr1);
+    for (auto extension : {".lr1t", ".lr1s"}) {
+        ofstream out{directory + "/" + key + extension, ios::binary | ios::trunc};
+        out << "LR1";
+    }
+    auto table = cache.table(context);
+    EXPECT_EQ(table->view().states, states.size());
+    expectSameStates(cache.states(context), states);
+    EXPECT_EQ(cache.misses(), 2);
+    EXPECT_EQ(cache.hits(), 1);
+
+    // a valid header with a state count far beyond the file
+    {
+        fstream file{directory + "/" + key + ".lr1s", ios::binary | ios::in | ios::out};
+        uint32_t count = 0xffffffff;
+        file.seekp(5 * sizeof(uint32_t));
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    }
+    expectSameStates(cache.states(context), states);
+    EXPECT_EQ(cache.misses(), 3);
+    expectSameStates(cache.states(context), states);
+    EXPECT_EQ(cache.hits(), 2);
+}
+
+TEST_F(Cache, ConcurrentWritersShouldLeaveCompleteFiles) {
+    LuaGrammar lua{};
+    vector<thread> writers{};
+    vector<size_t> stateCounts(8, 0);
+    for (size_t i = 0; i < stateCounts.size(); i++) {
+        writers.emplace_back([&, i]() {
+            TableCache cache{directory};
+            Context context{lua.productionList, lua.productionList[0]};
+            stateCounts[i] = cache.table(context)->view().states;
+        });
+    }
+    for (auto &writer : writers) {
+        writer.join();
+    }
+    EXPECT_THAT(stateCounts, Each(Eq(stateCounts[0])));
+    // the temporary files were all renamed
+    EXPECT_EQ(files(), 2);
+    TableCache cache{directory};
+    Context context{lua.productionList, lua.productionList[0]};
+    EXPECT_EQ(cache.table(context)->view().states, stateCounts[0]);
+    EXPECT_EQ(cache.hits(), 1);
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
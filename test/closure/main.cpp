@@ -3,6 +3,7 @@
 
 using namespace std;
 using namespace testing;
+const static Item Eof{"$", ItemType::Terminal};
 
 class Closure : public Test {
 public:
@@ -56,6 +57,89 @@ TEST_F(Closure, ClouseShouldInitTheStartItemSet) {
     EXPECT_THAT(result, expected);
 }
 
+TEST_F(Closure, RepeatedKernelShouldHitTheClosureCache) {
+    set<Item> cc_Set{c, d};
+    context.first();
+    vector<Handler> kernel{Handler{productions[2], 1, cc_Set}, Handler{productions[1], 1, set<Item>{Eof}}};
+    auto result = context.closureItemSet(kernel);
+    EXPECT_EQ(context.getClosureCache().misses(), 1);
+    EXPECT_EQ(context.getClosureCache().hits(), 0);
+
+    vector<Handler> reversed{kernel.rbegin(), kernel.rend()};
+    EXPECT_THAT(context.closureItemSet(reversed), result);
+    EXPECT_EQ(context.getClosureCache().hits(), 1);
+
+    vector<Handler> otherLook{Handler{productions[2], 1, set<Item>{c}}};
+    context.closureItemSet(otherLook);
+    EXPECT_EQ(context.getClosureCache().misses(), 2);
+    EXPECT_EQ(context.getClosureCache().size(), 2);
+}
+
+TEST_F(Closure, ClosureCacheShouldStayInsideItsByteLimit) {
+    set<Item> cc_Set{c, d};
+    context.first();
+    vector<Handler> kernel{Handler{productions[2], 1, cc_Set}};
+    context.closureItemSet(kernel);
+    auto entryBytes = context.getClosureCache().bytes();
+    context.setClosureCacheLimit(entryBytes);
+    vector<Handler> otherKernel{Handler{productions[1], 1, set<Item>{Eof}}};
+    context.closureItemSet(otherKernel);
+    EXPECT_LE(context.getClosureCache().bytes(), entryBytes);
+    EXPECT_EQ(context.getClosureCache().evictions(), 1);
+
+    context.setClosureCacheLimit(0);
+    EXPECT_EQ(context.getClosureCache().size(), 0);
+    context.closureItemSet(otherKernel);
+    EXPECT_EQ(context.getClosureCache().hits(), 0);
+}
+
+TEST_F(Closure, MovedContextShouldCloseAgainstItsOwnGrammar) {
+    set<Item> cc_Set{c, d};
+    auto original = make_unique<Context>(productions, productions[0]);
+    original->first();
+    vector<Handler> kernel{Handler{productions[2], 1, cc_Set}};
+    auto expected = original->closureItemSet(kernel);
+
+    Context moved{move(*original)};
+    original.reset();
+    EXPECT_THAT(moved.closureItemSet(kernel), expected);
+    EXPECT_EQ(moved.getClosureCache().hits(), 1);
+    vector<Handler> otherKernel{Handler{productions[1], 1, set<Item>{Eof}}};
+    EXPECT_THAT(moved.closureItemSet(otherKernel), context.closureItemSet(otherKernel));
+
+    context = move(moved);
+    EXPECT_EQ(context.generalLr1().size(), 10);
+}
+
+TEST(LeftRecursiveClosure, LookForwardOfLeftRecursionShouldBeMerged) {
+    Item S{"S", ItemType::NoTerminal};
+    Item E{"E", ItemType::NoTerminal};
+    Item T{"T", ItemType::NoTerminal};
+    Item plus{"+", ItemType::Terminal};
+    Item i{"i", ItemType::Terminal};
+    Item eof{"$", ItemType::Terminal};
+    vector<Production> productions{
+            Production{S, vector<Item>{E}},
+            Production{E, vector<Item>{E, plus, T}},
+            Production{E, vector<Item>{T}},
+            Production{T, vector<Item>{i}},
+    };
+    Context context{productions, productions[0]};
+    context.first();
+    Handler startHandler{productions[0], 0, set<Item>{eof}};
+    vector<Handler> result{};
+    context.closureSet(startHandler, result);
+
+    set<Item> look{eof, plus};
+    vector<Handler> expected{
+            Handler{productions[0], 0, set<Item>{eof}},
+            Handler{productions[1], 0, look},
+            Handler{productions[2], 0, look},
+            Handler{productions[3], 0, look},
+    };
+    EXPECT_THAT(result, expected);
+}
+
 int main(int argc, char *argv[]) {
     InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,41 @@
+#ifndef DIRECT_GRAMMARS_H
+#define DIRECT_GRAMMARS_H
+
+#include "../../src/Context.h"
+
+// the grammars the direct code test generates parsers for, shared by the generator and the test.
+struct PairGrammar {
+    Item S_{"S_", ItemType::NoTerminal};
+    Item S{"S", ItemType::NoTerminal};
+    Item C{"C", ItemType::NoTerminal};
+    Item c{"c", ItemType::Terminal};
+    Item d{"d", ItemType::Terminal};
+    std::vector<Production> productionList{
+            Production{S_, std::vector<Item>{S}},
+            Production{S, std::vector<Item>{C, C}},
+            Production{C, std::vector<Item>{c, C}},
+            Production{C, std::vector<Item>{d}},
+    };
+};
+
+struct NullableGrammar {
+    Item S_{"S_", ItemType::NoTerminal};
+    Item S{"S", ItemType::NoTerminal};
+    Item A{"A", ItemType::NoTerminal};
+    Item B{"B", ItemType::NoTerminal};
+    Item a{"a", ItemType::Terminal};
+    Item b{"b", ItemType::Terminal};
+    Item c{"c", ItemType::Terminal};
+    Item empty{"000", ItemType::Terminal};
+    std::vector<Production> productionList{
+            Production{S_, std::vector<Item>{S}},
+            Production{S, std::vector<Item>{A, B, c}},
+            Production{S, std::vector<Item>{S, A, B}},
+            Production{A, std::vector<Item>{a}},
+            Production{A, std::vector<Item>{empty}},
+            Production{B, std::vector<Item>{b}},
+            Production{B, std::vector<Item>{empty}},
+    };
+};
+
+#endif
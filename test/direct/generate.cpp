@@ -0,0 +1,31 @@
+#include "../../src/Context.h"
+#include "../../src/DirectCode.h"
+#include "../../src/TableOptimizer.h"
+#include "DirectGrammars.h"
+#include <fstream>
+
+// writes the directly coded parsers of the test grammars to the header given as argument
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        return 1;
+    }
+    int eof = Item{"$", ItemType::Terminal}.getId();
+    std::ofstream out{argv[1]};
+    PairGrammar pair{};
+    Context pairContext{pair.productionList, pair.productionList[0]};
+    auto pairStates = pairContext.generalLr1();
+    auto pairTable = pairContext.table(pairStates);
+    out << DirectCodeGenerator{pairTable, eof}.generate("pair_direct");
+
+    NullableGrammar nullable{};
+    Context nullableContext{nullable.productionList, nullable.productionList[0]};
+    auto nullableStates = nullableContext.generalLr1();
+    auto nullableTable = nullableContext.table(nullableStates);
+    out << DirectCodeGenerator{nullableTable, eof}.generate("nullable_direct");
+
+    TableOptimizer optimizer{nullableTable};
+    optimizer.addDefaultReductions();
+    optimizer.eliminateUnitRules();
+    out << DirectCodeGenerator{nullableTable, eof}.generate("nullable_optimized");
+    return out ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include <gmock/gmock.h>
+#include "../../src/Context.h"
+#include "../../src/LrParser.h"
+#include "../../src/TableOptimizer.h"
+#include "DirectGrammars.h"
+#include "DirectParsers.h"
+
+using namespace std;
+using namespace testing;
+
+using Reduces = vector<tuple<int, size_t, size_t>>;
+
+// every token sequence up to length over the terminals of the table gets the same result and the same
+// reduces from the generated parser as from LrParser
+template<typename Parse>
+static void expectSameAsTable(ParseTable &table, size_t length, Parse &&parse) {
+    LrParser parser{table, Item{"$", ItemType::Terminal}.getId()};
+    Reduces expected{};
+    parser.onReduce([&expected](int production, size_t begin, size_t end) {
+        expected.emplace_back(production, begin, end);
+    });
+    // the end of input column is left out, it is implied
+    vector<int> alphabet{};
+    for (int column = 0; column < static_cast<int>(table.terminalCount()); column++) {
+        if (Item{table.terminals()[column]}.getName() != "$") {
+            alphabet.push_back(column);
+        }
+    }
+    vector<size_t> digits{};
+    size_t accepted = 0;
+    for (size_t n = 0; n <= length; n++) {
+        digits.assign(n, 0);
+        while (true) {
+            vector<int> columns{};
+            vector<int> symbols{};
+            for (auto digit : digits) {
+                columns.push_back(alphabet[digit]);
+                symbols.push_back(table.terminals()[alphabet[digit]]);
+            }
+            expected.clear();
+            auto result = parser.parse(symbols);
+            Reduces actual{};
+            auto direct = parse(columns, actual);
+            EXPECT_EQ(direct.accepted, result.accepted);
+            EXPECT_EQ(direct.position, result.position);
+            EXPECT_EQ(actual, expected);
+            accepted += result.accepted;
+            size_t i = 0;
+            for (; i < n && ++digits[i] == alphabet.size(); i++) {
+                digits[i] = 0;
+            }
+            if (i == n) {
+                break;
+            }
+        }
+    }
+    EXPECT_GT(accepted, 0);
+}
+
+TEST(DirectCode, PairParserShouldMatchTheTable) {
+    PairGrammar grammar{};
+    Context context{grammar.productionList, grammar.productionList[0]};
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    EXPECT_EQ(pair_direct::terminalCount, static_cast<int>(table.terminalCount()));
+    vector<int> stateStack(1);
+    vector<size_t> startStack(1);
+    expectSameAsTable(table, 6, [&](const vector<int> &columns, Reduces &reduces) {
+        return pair_direct::parse(columns.data(), columns.size(), stateStack, startStack,
+                                  [&reduces](int production, size_t begin, size_t end) {
+                                      reduces.emplace_back(production, begin, end);
+                                  });
+    });
+    EXPECT_GE(stateStack.size(), 6);
+}
+
+TEST(DirectCode, NullableParserShouldMatchTheTable) {
+    NullableGrammar grammar{};
+    Context context{grammar.productionList, grammar.productionList[0]};
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    vector<int> stateStack{};
+    vector<size_t> startStack{};
+    expectSameAsTable(table, 5, [&](const vector<int> &columns, Reduces &reduces) {
+        return nullable_direct::parse(columns.data(), columns.size(), stateStack, startStack,
+                                      [&reduces](int production, size_t begin, size_t end) {
+                                          reduces.emplace_back(production, begin, end);
+                                      });
+    });
+}
+
+TEST(DirectCode, DefaultReductionsShouldBeTheDefaultCase) {
+    NullableGrammar grammar{};
+    Context context{grammar.productionList, grammar.productionList[0]};
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    TableOptimizer optimizer{table};
+    EXPECT_GT(optimizer.addDefaultReductions().defaultReductions, 0);
+    optimizer.eliminateUnitRules();
+    vector<int> stateStack{};
+    vector<size_t> startStack{};
+    expectSameAsTable(table, 5, [&](const vector<int> &columns, Reduces &reduces) {
+        return nullable_optimized::parse(columns.data(), columns.size(), stateStack, startStack,
+                                         [&reduces](int production, size_t begin, size_t end) {
+                                             reduces.emplace_back(production, begin, end);
+                                         });
+    });
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
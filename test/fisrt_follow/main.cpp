@@ -5,7 +5,7 @@ using namespace std;
 using namespace testing;
 const static Item Eof{"$", ItemType::Terminal};
 
-class Grammar : public ::testing::Test {
+class FirstFollowGrammar : public ::testing::Test {
 public:
     vector<Item> items{
             Item{"E", ItemType::NoTerminal},
@@ -13,7 +13,7 @@ public:
             Item{"T", ItemType::NoTerminal},
             Item{"T_", ItemType::NoTerminal},
             Item{"F", ItemType::NoTerminal},
-            Item{"^", ItemType::Terminal},
+            Item{"000", ItemType::Terminal},
             Item{"+", ItemType::Terminal},
             Item{"*", ItemType::Terminal},
             Item{"(", ItemType::Terminal},
@@ -34,7 +34,7 @@ public:
 
 };
 
-TEST_F(Grammar, GivenGrammarShouldHaveExpectedFirstSet) {
+TEST_F(FirstFollowGrammar, GivenGrammarShouldHaveExpectedFirstSet) {
     vector<Production> grammar{
             Production{E, vector<Item>{T, E_}},
             Production{E_, vector<Item>{plus, T, E_}},
@@ -55,7 +55,7 @@ TEST_F(Grammar, GivenGrammarShouldHaveExpectedFirstSet) {
 }
 
 
-TEST_F(Grammar, GivenGrammarShouldHaveExpectedFollowSet) {
+TEST_F(FirstFollowGrammar, GivenGrammarShouldHaveExpectedFollowSet) {
     vector<Production> grammar{
             Production{E, vector<Item>{T, E_}},
             Production{E_, vector<Item>{plus, T, E_}},
@@ -75,6 +75,26 @@ TEST_F(Grammar, GivenGrammarShouldHaveExpectedFollowSet) {
     EXPECT_THAT(context.followAt(F)->second, F_FOLLOW);
 }
 
+TEST(FirstFollowEngine, UnitProductionOfNullableNoTerminalShouldBeNullable) {
+    Item S{"S", ItemType::NoTerminal};
+    Item A{"A", ItemType::NoTerminal};
+    Item B{"B", ItemType::NoTerminal};
+    Item c{"c", ItemType::Terminal};
+    Item epsilon{"000", ItemType::Terminal};
+    vector<Production> grammar{
+            Production{S, vector<Item>{A, c}},
+            Production{A, vector<Item>{B}},
+            Production{B, vector<Item>{epsilon}},
+    };
+    Context context{grammar, grammar.front()};
+    context.first();
+    context.follow();
+    EXPECT_TRUE(context.isNullable(A));
+    EXPECT_THAT(context.firstAt(A)->second, (set<Item>{epsilon}));
+    EXPECT_THAT(context.firstAt(S)->second, (set<Item>{c}));
+    EXPECT_THAT(context.followAt(B)->second, (set<Item>{c}));
+}
+
 int main(int argc, char *argv[]) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -4,6 +4,8 @@
 
 #include <gmock/gmock.h>
 #include "../../src/Context.h"
+#include "../../src/ThreadPool.h"
+#include <atomic>
 #include <cstdio>
 
 using namespace std;
@@ -75,6 +77,147 @@ TEST_F(Goto, ShouldReturnNextHandlerSet) {
     }
 }
 
+TEST_F(Goto, ShouldRecordEveryTransitionOnce) {
+    context.first();
+    context.follow();
+    auto result = context.generalLr1();
+    EXPECT_EQ(result.size(), 10);
+    size_t transitions = 0;
+    for (auto &state : result) {
+        transitions += state.transitionList().size();
+        for (auto &t : state.transitionList()) {
+            EXPECT_EQ(result[t.second].shiftItem().getId(), t.first);
+        }
+    }
+    EXPECT_EQ(transitions, 13);
+    auto next = result[0].transition(c);
+    ASSERT_NE(next, -1);
+    EXPECT_EQ(result[next].transition(c), next);
+    EXPECT_EQ(result[0].transition(Item{"$", ItemType::Terminal}), -1);
+}
+
+TEST_F(Goto, TableShouldUseTheRecordedTransitions) {
+    context.first();
+    context.follow();
+    auto result = context.generalLr1();
+    auto table = context.table(result);
+    for (size_t i = 0; i < result.size(); i++) {
+        for (auto &t : result[i].transitionList()) {
+            Item symbol{t.first};
+            if (symbol.isTerminal()) {
+                auto action = table.action(i, table.terminalColumn(t.first));
+                EXPECT_EQ(action.type, ActionType::Shift);
+                EXPECT_EQ(action.value, t.second);
+            } else {
+                EXPECT_EQ(table.goTo(i, table.noTerminalColumn(t.first)), t.second);
+            }
+        }
+    }
+
+    vector<HandlerSet> withoutTransitions{result[0]};
+    withoutTransitions[0] = HandlerSet{result[0].shiftItem(), result[0].ruleList()};
+    EXPECT_THROW(context.table(withoutTransitions), runtime_error);
+}
+
+TEST_F(Goto, ParallelStatesShouldMatchTheSerialOnes) {
+    context.first();
+    auto serial = context.generalLr1();
+    auto serialTable = context.table(serial);
+    for (size_t threads : {1, 3}) {
+        auto parallel = context.generateLr1Parallel(threads);
+        ASSERT_EQ(parallel.size(), serial.size());
+        for (size_t i = 0; i < serial.size(); i++) {
+            EXPECT_EQ(parallel[i].shiftItem(), serial[i].shiftItem());
+            EXPECT_EQ(parallel[i].getParentId(), serial[i].getParentId());
+            EXPECT_EQ(parallel[i].transitionList(), serial[i].transitionList());
+            EXPECT_EQ(parallel[i].ruleList(), serial[i].ruleList());
+        }
+        auto table = context.table(parallel);
+        EXPECT_EQ(table.actionData(), serialTable.actionData());
+        EXPECT_EQ(table.gotoData(), serialTable.gotoData());
+    }
+}
+
+TEST(AmbiguousTable, ShouldKeepTheFirstActionAndReportTheOthers) {
+    Item S{"S", ItemType::NoTerminal};
+    Item E{"E", ItemType::NoTerminal};
+    Item plus{"+", ItemType::Terminal};
+    Item a{"a", ItemType::Terminal};
+    vector<Production> productions{
+            Production{S, vector<Item>{E}},
+            Production{E, vector<Item>{E, plus, E}},
+            Production{E, vector<Item>{a}},
+    };
+    Context context{productions, productions[0]};
+    context.first();
+    auto states = context.generalLr1();
+    auto serial = context.table(states);
+    auto conflicts = context.getConflicts();
+    ASSERT_FALSE(conflicts.empty());
+    for (auto &conflict : conflicts) {
+        EXPECT_EQ(conflict.symbol, plus.getId());
+        EXPECT_EQ(serial.action(conflict.state, serial.terminalColumn(conflict.symbol)), conflict.first);
+        EXPECT_NE(conflict.first, conflict.second);
+    }
+
+    auto parallel = context.table(states, 3);
+    EXPECT_EQ(parallel.actionData(), serial.actionData());
+    EXPECT_EQ(parallel.gotoData(), serial.gotoData());
+    ASSERT_EQ(context.getConflicts().size(), conflicts.size());
+    for (size_t i = 0; i < conflicts.size(); i++) {
+        EXPECT_EQ(context.getConflicts()[i].state, conflicts[i].state);
+        EXPECT_EQ(context.getConflicts()[i].first, conflicts[i].first);
+        EXPECT_EQ(context.getConflicts()[i].second, conflicts[i].second);
+    }
+}
+
+TEST(ThreadPoolLoop, ShouldRunEveryIndexOnce) {
+    ThreadPool pool{4};
+    EXPECT_EQ(pool.size(), 4);
+    for (size_t count : {0, 1, 7, 1000}) {
+        vector<atomic<int>> runs(count);
+        pool.parallelFor(count, [&runs, &pool](size_t index, size_t worker) {
+            EXPECT_LT(worker, pool.size());
+            runs[index]++;
+        });
+        for (auto &run : runs) {
+            EXPECT_EQ(run.load(), 1);
+        }
+    }
+    EXPECT_THROW(pool.parallelFor(100, [](size_t index, size_t) {
+        if (index == 42) {
+            throw runtime_error("task failed");
+        }
+    }), runtime_error);
+    size_t sum = 0;
+    ThreadPool{1}.parallelFor(10, [&sum](size_t index, size_t) { sum += index; });
+    EXPECT_EQ(sum, 45);
+}
+
+TEST(ParseTableCells, ShouldKeepTheFirstActionOfACell) {
+    ParseTable table{2, vector<int>{10, 11}, vector<int>{20}};
+    EXPECT_EQ(table.action(1, 1).type, ActionType::Error);
+    EXPECT_TRUE(table.setAction(1, 1, ParseAction{ActionType::Shift, 1}));
+    EXPECT_TRUE(table.setAction(1, 1, ParseAction{ActionType::Shift, 1}));
+    EXPECT_FALSE(table.setAction(1, 1, ParseAction{ActionType::Reduce, 3}));
+    EXPECT_EQ(table.action(1, 1), (ParseAction{ActionType::Shift, 1}));
+    EXPECT_EQ(table.action(0, 1).type, ActionType::Error);
+    table.setAction(0, 0, ParseAction{ActionType::Accept, 0});
+    EXPECT_EQ(table.action(0, 0), (ParseAction{ActionType::Accept, 0}));
+    EXPECT_EQ(table.goTo(0, 0), -1);
+    table.setGoto(0, 0, 1);
+    EXPECT_EQ(table.goTo(0, 0), 1);
+    EXPECT_EQ(table.terminalColumn(11), 1);
+    EXPECT_EQ(table.noTerminalColumn(20), 0);
+    EXPECT_EQ(table.terminalColumn(20), -1);
+
+    auto footprint = table.footprint();
+    EXPECT_EQ(footprint.actionCells, 4);
+    EXPECT_EQ(footprint.actionEntries, 2);
+    EXPECT_EQ(footprint.gotoEntries, 1);
+    EXPECT_EQ(footprint.actionBytes, 4 * sizeof(int32_t));
+}
+
 int main(int argc, char *argv[]) {
     InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,71 @@
+#include <gmock/gmock.h>
+#include "../../src/Context.h"
+
+using namespace std;
+using namespace testing;
+
+class SymbolGrammar : public Test {
+public:
+    vector<Item> itemList{
+            Item{"S_", ItemType::NoTerminal},
+            Item{"S", ItemType::NoTerminal},
+            Item{"C", ItemType::NoTerminal},
+            Item{"c", ItemType::Terminal},
+            Item{"d", ItemType::Terminal},
+    };
+    Item &S_ = itemList[0];
+    Item &S = itemList[1];
+    Item &C = itemList[2];
+    Item &c = itemList[3];
+    Item &d = itemList[4];
+    vector<Production> productions{
+            Production{S_, vector<Item>{S}},
+            Production{S, vector<Item>{C, C}},
+            Production{C, vector<Item>{c, C}},
+            Production{C, vector<Item>{d}},
+    };
+
+    Context context{productions, productions[0]};
+};
+
+TEST_F(SymbolGrammar, SameNameShouldShareTheSymbolId) {
+    Item other{"S", ItemType::NoTerminal};
+    EXPECT_EQ(other.getId(), S.getId());
+    EXPECT_EQ(other, S);
+    EXPECT_EQ(other.getName(), "S");
+}
+
+TEST_F(SymbolGrammar, TerminalAndNoTerminalWithSameNameShouldDiffer) {
+    Item terminal{"S", ItemType::Terminal};
+    EXPECT_NE(terminal.getId(), S.getId());
+    EXPECT_TRUE(terminal.isTerminal());
+    EXPECT_TRUE(S.isNoTerminal());
+}
+
+TEST_F(SymbolGrammar, GrammarShouldIndexTheSymbolsDensely) {
+    auto &grammar = context.getGrammar();
+    vector<string> terminals{};
+    for (auto t : grammar.terminals()) {
+        terminals.push_back(grammar.name(t));
+    }
+    EXPECT_THAT(terminals, ElementsAre("$", "c", "d"));
+    EXPECT_EQ(grammar.terminalIndex(c.getId()), 1);
+    EXPECT_EQ(grammar.terminalIndex(C.getId()), -1);
+    EXPECT_EQ(grammar.noTerminals().size(), 3);
+    EXPECT_EQ(grammar.noTerminalIndex(S_.getId()), 2);
+    EXPECT_EQ(grammar.startSymbol(), S_.getId());
+    EXPECT_EQ(grammar.startProduction(), 0);
+}
+
+TEST_F(SymbolGrammar, GrammarShouldIndexTheProductionsByNoTerminal) {
+    auto &grammar = context.getGrammar();
+    EXPECT_THAT(grammar.productionsOf(C.getId()), ElementsAre(2, 3));
+    EXPECT_THAT(grammar.productionsOf(c.getId()), IsEmpty());
+    EXPECT_THAT(grammar.rhs(1), ElementsAre(C.getId(), C.getId()));
+    EXPECT_EQ(grammar.lhs(3), C.getId());
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,142 @@
+#include <gmock/gmock.h>
+#include "../../src/Arena.h"
+#include "../../src/Context.h"
+#include "../lua/LuaGrammar.h"
+
+using namespace std;
+using namespace testing;
+
+static Item t(const string &name) {
+    return Item{name, ItemType::Terminal};
+}
+
+static Item n(const string &name) {
+    return Item{name, ItemType::NoTerminal};
+}
+
+TEST(Handler, EqualLookForwardSetsShouldBeOneObject) {
+    auto &look = LookForward::intern(set<Item>{t("b"), t("a"), t("$")});
+    set<Item> sorted{t("$"), t("a"), t("b")};
+    auto &same = LookForward::intern(vector<Item>{sorted.begin(), sorted.end()});
+    EXPECT_EQ(&look, &same);
+    EXPECT_EQ(look, (set<Item>{t("a"), t("b"), t("$")}));
+    EXPECT_NE(look, (set<Item>{t("a"), t("b")}));
+    EXPECT_EQ(look.size(), 3);
+    EXPECT_EQ(look.count(t("a")), 1);
+    EXPECT_EQ(look.count(t("c")), 0);
+    EXPECT_TRUE(std::is_sorted(look.begin(), look.end()));
+
+    auto &smaller = LookForward::intern(set<Item>{t("a")});
+    EXPECT_EQ(&smaller.merge(look), &look);
+    EXPECT_EQ(&look.merge(LookForward::none()), &look);
+    EXPECT_EQ(&LookForward::none(), &LookForward::intern(set<Item>{}));
+    EXPECT_TRUE(LookForward::none().empty());
+}
+
+TEST(Handler, MergeShouldInternIntoThePoolOfTheMergedSet) {
+    auto pool = make_shared<InternPool>();
+    auto otherPool = make_shared<InternPool>();
+    set<Item> items{t("a"), t("b")};
+    vector<Item> sorted{items.begin(), items.end()};
+    auto &other = otherPool->intern(sorted.data(), sorted.data() + sorted.size());
+
+    auto &merged = pool->none().merge(other);
+    EXPECT_NE(&merged, &other);
+    EXPECT_EQ(&merged.pool(), pool.get());
+    EXPECT_EQ(merged, items);
+    EXPECT_EQ(&otherPool->none().merge(other), &other);
+}
+
+TEST(Handler, ShouldShareProductionsAndLookForwardSets) {
+    Production production{n("E"), {n("E"), t("+"), n("T")}};
+    Production copy{n("E"), {n("E"), t("+"), n("T")}};
+    Production other{n("E"), {n("T")}};
+    EXPECT_EQ(&ProductionTable::global().intern(production), &ProductionTable::global().intern(copy));
+    EXPECT_NE(&ProductionTable::global().intern(production), &ProductionTable::global().intern(other));
+
+    Handler handler{production, 0, set<Item>{t("$"), t("+")}};
+    Handler same{copy, 0, set<Item>{t("+"), t("$")}};
+    EXPECT_EQ(handler, same);
+    EXPECT_EQ(handler.hash(), same.hash());
+    EXPECT_EQ(&handler.getProduction(), &same.getProduction());
+    EXPECT_LE(sizeof(Handler), 3 * sizeof(void *));
+
+    auto next = handler.nextHandler();
+    EXPECT_EQ(&next.getProduction(), &handler.getProduction());
+    EXPECT_EQ(&next.getLookForward(), &handler.getLookForward());
+    EXPECT_EQ(next.getPosition(), 1);
+    EXPECT_EQ(next.current(), t("+"));
+    EXPECT_FALSE(next == handler);
+    EXPECT_TRUE(handler < next);
+
+    set<Item> more{t(")")};
+    next.addLookForward(more.begin(), more.end());
+    EXPECT_EQ(next.getLookForward(), (set<Item>{t("$"), t("+"), t(")")}));
+    EXPECT_EQ(handler.getLookForward(), (set<Item>{t("$"), t("+")}));
+}
+
+TEST(Handler, LuaStatesShouldShareTheirLookForwardSets) {
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    auto states = context.generalLr1();
+    set<const LookForward *> looks{};
+    set<const Production *> productions{};
+    size_t items = 0;
+    for (auto &state : states) {
+        for (auto &handler : state.ruleList()) {
+            looks.insert(&handler.getLookForward());
+            productions.insert(&handler.getProduction());
+            items++;
+        }
+    }
+    EXPECT_LE(productions.size(), lua.productionList.size());
+    // far fewer distinct look forward sets than items
+    EXPECT_LT(looks.size() * 4, items);
+}
+
+TEST(Handler, InternPoolShouldBeReleasedWithTheLastContextAndState) {
+    LuaGrammar lua{};
+    weak_ptr<InternPool> released{};
+    vector<HandlerSet> states{};
+    {
+        Context context{lua.productionList, lua.productionList[0]};
+        states = context.generalLr1();
+        released = InternPool::acquire();
+        // a second context alive at the same time shares the pool, so its handlers compare equal
+        Context other{lua.productionList, lua.productionList[0]};
+        EXPECT_EQ(InternPool::acquire(), released.lock());
+        EXPECT_EQ(other.generalLr1()[0].ruleList(), states[0].ruleList());
+        EXPECT_GT(released.lock()->lookForwardBytes(), 0);
+    }
+    // the states outlive their context and keep the pool
+    ASSERT_FALSE(released.expired());
+    EXPECT_EQ(states[0].ruleList()[0].getProduction(), lua.productionList[0]);
+    states.clear();
+    EXPECT_TRUE(released.expired());
+
+    // a context created afterwards starts a new pool
+    Context next{lua.productionList, lua.productionList[0]};
+    weak_ptr<InternPool> fresh = InternPool::acquire();
+    next.generalLr1();
+    EXPECT_EQ(fresh.lock()->productions().size(), lua.productionList.size());
+}
+
+TEST(Handler, ArenaShouldAlignAndReleaseInBulk) {
+    Arena arena{256};
+    auto bytes = arena.allocate<char>(3);
+    auto words = arena.allocate<uint64_t>(4);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(words) % alignof(uint64_t), 0);
+    EXPECT_NE(static_cast<void *>(bytes), static_cast<void *>(words));
+    auto large = arena.allocate<uint64_t>(1000);
+    large[999] = 1;
+    EXPECT_EQ(arena.bytes(), 3 + 4 * sizeof(uint64_t) + 1000 * sizeof(uint64_t));
+    EXPECT_GE(arena.capacity(), arena.bytes());
+    arena.release();
+    EXPECT_EQ(arena.bytes(), 0);
+    EXPECT_EQ(arena.capacity(), 0);
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,108 @@
+#include <gmock/gmock.h>
+#include "../../src/Incremental.h"
+#include "../../src/GrammarFile.h"
+#include "../lua/ExpressionGrammar.h"
+#include "../lua/LuaGrammar.h"
+
+using namespace std;
+using namespace testing;
+
+static vector<string> names(const vector<Item> &items) {
+    vector<string> result{};
+    for (auto &item : items) {
+        result.push_back(item.getName());
+    }
+    return result;
+}
+
+// the incremental states and table have to be the ones of a full generation of the same grammar
+static void expectSameAutomaton(IncrementalLr1 &incremental, Context fresh) {
+    auto states = fresh.generalLr1();
+    auto &updated = incremental.states();
+    ASSERT_EQ(updated.size(), states.size());
+    for (size_t i = 0; i < states.size(); i++) {
+        ASSERT_TRUE(states[i].sameKernel(updated[i])) << "state " << i;
+        ASSERT_EQ(states[i].ruleList().size(), updated[i].ruleList().size()) << "state " << i;
+        ASSERT_EQ(states[i].transitionList(), updated[i].transitionList()) << "state " << i;
+    }
+    auto expected = fresh.table(states);
+    auto table = incremental.table();
+    EXPECT_EQ(table.actionData(), expected.actionData());
+    EXPECT_EQ(table.gotoData(), expected.gotoData());
+    EXPECT_EQ(incremental.context().getConflicts().size(), fresh.getConflicts().size());
+}
+
+TEST(Incremental, AnUnchangedGrammarShouldReuseEveryState) {
+    LuaGrammar lua{};
+    IncrementalLr1 incremental{Context{lua.productionList, lua.productionList[0]}};
+    auto count = incremental.states().size();
+    auto update = incremental.update(Context{lua.productionList, lua.productionList[0]});
+    EXPECT_EQ(update.addedProductions, 0);
+    EXPECT_EQ(update.removedProductions, 0);
+    EXPECT_TRUE(update.changedRules.empty());
+    EXPECT_TRUE(update.changedFirst.empty());
+    EXPECT_EQ(update.reusedStates, count);
+    EXPECT_EQ(update.closedStates, 0);
+    expectSameAutomaton(incremental, Context{lua.productionList, lua.productionList[0]});
+}
+
+TEST(Incremental, EditingAStatementShouldOnlyCloseTheStatesReadingIt) {
+    LuaGrammar lua{};
+    IncrementalLr1 incremental{Context{lua.productionList, lua.productionList[0]}};
+    auto edited = lua.productionList;
+    Production repeat{lua.stat, {lua.repeat, lua.block, lua.until, lua.exp}};
+    auto found = find(edited.begin(), edited.end(), repeat);
+    ASSERT_NE(found, edited.end());
+    *found = Production{lua.stat, {lua.repeat, lua.block, lua.until, lua.exp, lua.end_}};
+
+    auto update = incremental.update(Context{edited, edited[0]});
+    EXPECT_EQ(update.addedProductions, 1);
+    EXPECT_EQ(update.removedProductions, 1);
+    EXPECT_THAT(names(update.changedRules), ElementsAre("#stat"));
+    EXPECT_TRUE(update.changedFirst.empty());
+    EXPECT_EQ(update.reusedStates + update.closedStates, incremental.states().size());
+    // the expression states, most of the automaton, do not read #stat
+    EXPECT_GT(update.reusedStates, update.closedStates * 2);
+    expectSameAutomaton(incremental, Context{edited, edited[0]});
+
+    // and back again
+    incremental.update(Context{lua.productionList, lua.productionList[0]});
+    expectSameAutomaton(incremental, Context{lua.productionList, lua.productionList[0]});
+}
+
+TEST(Incremental, ChangingAFirstSetShouldCloseTheStatesLookingAtIt) {
+    IncrementalLr1 incremental{GrammarFile::parse(expression).context()};
+    auto negated = string{expression} + "F ::= - F\n";
+    auto update = incremental.update(GrammarFile::parse(negated).context());
+    EXPECT_EQ(update.addedProductions, 1);
+    EXPECT_EQ(update.removedProductions, 0);
+    EXPECT_THAT(names(update.changedRules), ElementsAre("F"));
+    EXPECT_THAT(names(update.changedFirst), UnorderedElementsAre("S", "E", "T", "F"));
+    EXPECT_GT(update.closedStates, 0);
+    expectSameAutomaton(incremental, GrammarFile::parse(negated).context());
+
+    // an ε production changes the nullability of the look forward sets
+    auto optional = negated + "T ::= ε\n";
+    update = incremental.update(GrammarFile::parse(optional).context());
+    EXPECT_THAT(names(update.changedRules), ElementsAre("T"));
+    EXPECT_FALSE(update.changedFirst.empty());
+    expectSameAutomaton(incremental, GrammarFile::parse(optional).context());
+}
+
+TEST(Incremental, ANewStartProductionShouldCloseTheStartState) {
+    IncrementalLr1 incremental{GrammarFile::parse(expression).context()};
+    // S ::= E ; is no start production of its own, the file adds S_ ::= S in front of it
+    string grammar{expression};
+    auto edited = "S ::= E ;\n" + grammar.substr(grammar.find('\n') + 1);
+    auto update = incremental.update(GrammarFile::parse(edited).context());
+    EXPECT_EQ(update.addedProductions, 2);
+    EXPECT_EQ(update.removedProductions, 1);
+    EXPECT_THAT(names(update.changedRules), ElementsAre("S", "S_"));
+    EXPECT_GT(update.reusedStates, 0);
+    expectSameAutomaton(incremental, GrammarFile::parse(edited).context());
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
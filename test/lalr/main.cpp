@@ -0,0 +1,222 @@
+#include <gmock/gmock.h>
+#include "../../src/Context.h"
+
+using namespace std;
+using namespace testing;
+
+// the look forward of every lalr(1) item is the union over the canonical lr(1) states with the same core,
+// the lr(1) states are mapped onto the lalr(1) ones by following the same transitions from the start state.
+static void expectMergedLookForward(Context &context, vector<HandlerSet> &lr1, vector<HandlerSet> &lalr) {
+    auto &grammar = context.getGrammar();
+    vector<int> core(lr1.size(), -1);
+    core[0] = 0;
+    for (size_t i = 0; i < lr1.size(); i++) {
+        ASSERT_NE(core[i], -1);
+        for (auto &t : lr1[i].transitionList()) {
+            int next = lalr[core[i]].transition(Item{t.first});
+            ASSERT_NE(next, -1);
+            if (core[t.second] == -1) {
+                core[t.second] = next;
+            }
+            EXPECT_EQ(core[t.second], next);
+        }
+    }
+    auto key = [&grammar](Handler &handler) {
+        return make_pair(grammar.findProduction(handler.getProduction()), handler.getPosition());
+    };
+    map<pair<int, pair<int, int>>, set<Item>> merged{};
+    for (size_t i = 0; i < lr1.size(); i++) {
+        for (auto &handler : lr1[i].ruleList()) {
+            auto &look = merged[make_pair(core[i], key(handler))];
+            look.insert(handler.getLookForward().begin(), handler.getLookForward().end());
+        }
+    }
+    for (size_t i = 0; i < lalr.size(); i++) {
+        for (auto &handler : lalr[i].ruleList()) {
+            EXPECT_EQ(handler.getLookForward(), (merged[make_pair(static_cast<int>(i), key(handler))]));
+        }
+    }
+}
+
+// every action canonical lr(1) takes is taken by the merged state as well
+static void expectLr1Actions(Context &context, vector<HandlerSet> &lr1, vector<HandlerSet> &merged) {
+    auto lr1Table = context.table(lr1);
+    auto mergedTable = context.table(merged);
+    vector<int> core(lr1.size(), -1);
+    core[0] = 0;
+    for (size_t i = 0; i < lr1.size(); i++) {
+        for (auto &t : lr1[i].transitionList()) {
+            core[t.second] = merged[core[i]].transition(Item{t.first});
+            ASSERT_NE(core[t.second], -1);
+        }
+    }
+    for (size_t i = 0; i < lr1.size(); i++) {
+        for (size_t column = 0; column < lr1Table.terminalCount(); column++) {
+            auto action = lr1Table.action(i, column);
+            if (action.type == ActionType::Shift) {
+                action.value = core[action.value];
+            }
+            if (action.type != ActionType::Error) {
+                EXPECT_EQ(mergedTable.action(core[i], column), action);
+            }
+        }
+    }
+}
+
+class LalrGoto : public Test {
+public:
+    Item S_{"S_", ItemType::NoTerminal};
+    Item S{"S", ItemType::NoTerminal};
+    Item C{"C", ItemType::NoTerminal};
+    Item c{"c", ItemType::Terminal};
+    Item d{"d", ItemType::Terminal};
+    vector<Production> productions{
+            Production{S_, vector<Item>{S}},
+            Production{S, vector<Item>{C, C}},
+            Production{C, vector<Item>{c, C}},
+            Production{C, vector<Item>{d}},
+    };
+
+    Context context{productions, productions[0]};
+};
+
+TEST_F(LalrGoto, ShouldMergeTheStatesWithTheSameCore) {
+    context.first();
+    auto lr1 = context.generalLr1();
+    auto lalr = context.generateLalr1();
+    EXPECT_EQ(lr1.size(), 10);
+    EXPECT_EQ(lalr.size(), 7);
+    expectMergedLookForward(context, lr1, lalr);
+    EXPECT_TRUE(context.lalrConflicts(lalr).empty());
+
+    auto table = context.table(lalr);
+    EXPECT_EQ(table.stateCount(), 7);
+    int reduceD = 0;
+    for (size_t i = 0; i < lalr.size(); i++) {
+        if (table.action(i, table.terminalColumn(d.getId())) == ParseAction{ActionType::Reduce, 3}) {
+            reduceD++;
+            EXPECT_EQ(table.action(i, table.terminalColumn(c.getId())), (ParseAction{ActionType::Reduce, 3}));
+            EXPECT_EQ(table.action(i, table.terminalColumn(Item{"$", ItemType::Terminal}.getId())),
+                      (ParseAction{ActionType::Reduce, 3}));
+        }
+    }
+    EXPECT_EQ(reduceD, 1);
+}
+
+TEST_F(LalrGoto, MinimalLr1ShouldMergeAsLalr) {
+    context.first();
+    auto lr1 = context.generalLr1();
+    auto minimal = context.generateMinimalLr1();
+    EXPECT_EQ(minimal.size(), 7);
+    expectLr1Actions(context, lr1, minimal);
+}
+
+// S -> a A d | b B d | a B e | b A e is lr(1) but merging the two states of A -> c. and B -> c.
+// makes both productions reducible on d and e
+class LalrReduceConflict : public Test {
+public:
+    Item S_{"S_", ItemType::NoTerminal};
+    Item S{"S", ItemType::NoTerminal};
+    Item A{"A", ItemType::NoTerminal};
+    Item B{"B", ItemType::NoTerminal};
+    Item a{"a", ItemType::Terminal};
+    Item b{"b", ItemType::Terminal};
+    Item c{"c", ItemType::Terminal};
+    Item d{"d", ItemType::Terminal};
+    Item e{"e", ItemType::Terminal};
+    vector<Production> productions{
+            Production{S_, vector<Item>{S}},
+            Production{S, vector<Item>{a, A, d}},
+            Production{S, vector<Item>{b, B, d}},
+            Production{S, vector<Item>{a, B, e}},
+            Production{S, vector<Item>{b, A, e}},
+            Production{A, vector<Item>{c}},
+            Production{B, vector<Item>{c}},
+    };
+
+    Context context{productions, productions[0]};
+};
+
+TEST_F(LalrReduceConflict, ShouldReportTheConflictsCanonicalLr1DoesNotHave) {
+    context.first();
+    auto lr1 = context.generalLr1();
+    auto lalr = context.generateLalr1();
+    EXPECT_LT(lalr.size(), lr1.size());
+    expectMergedLookForward(context, lr1, lalr);
+
+    auto conflicts = context.lalrConflicts(lalr);
+    ASSERT_EQ(conflicts.size(), 2);
+    set<int> symbols{};
+    for (auto &conflict : conflicts) {
+        EXPECT_EQ(conflict.state, conflicts[0].state);
+        EXPECT_EQ(conflict.first, (ParseAction{ActionType::Reduce, 5}));
+        EXPECT_EQ(conflict.second, (ParseAction{ActionType::Reduce, 6}));
+        symbols.insert(conflict.symbol);
+    }
+    EXPECT_EQ(symbols, (set<int>{d.getId(), e.getId()}));
+    EXPECT_EQ(lalr[conflicts[0].state].shiftItem(), c);
+}
+
+TEST_F(LalrReduceConflict, MinimalLr1ShouldSplitOnlyTheConflictingState) {
+    context.first();
+    auto lr1 = context.generalLr1();
+    auto lalr = context.generateLalr1();
+    auto minimal = context.generateMinimalLr1();
+    EXPECT_EQ(minimal.size(), lalr.size() + 1);
+    EXPECT_EQ(minimal.size(), lr1.size());
+    expectLr1Actions(context, lr1, minimal);
+    int reduceStates = 0;
+    for (auto &state : minimal) {
+        if (state.shiftItem() == c) {
+            reduceStates++;
+            for (auto &handler : state.ruleList()) {
+                EXPECT_EQ(handler.getLookForward().size(), 1);
+            }
+        }
+    }
+    EXPECT_EQ(reduceStates, 2);
+}
+
+// the look forward of A -> . is read through the nullable B: {b, c}
+class LalrNullable : public Test {
+public:
+    Item S_{"S_", ItemType::NoTerminal};
+    Item S{"S", ItemType::NoTerminal};
+    Item A{"A", ItemType::NoTerminal};
+    Item B{"B", ItemType::NoTerminal};
+    Item a{"a", ItemType::Terminal};
+    Item b{"b", ItemType::Terminal};
+    Item c{"c", ItemType::Terminal};
+    Item empty{"000", ItemType::Terminal};
+    vector<Production> productions{
+            Production{S_, vector<Item>{S}},
+            Production{S, vector<Item>{A, B, c}},
+            Production{S, vector<Item>{S, A, B}},
+            Production{A, vector<Item>{a}},
+            Production{A, vector<Item>{empty}},
+            Production{B, vector<Item>{b}},
+            Production{B, vector<Item>{empty}},
+    };
+
+    Context context{productions, productions[0]};
+};
+
+TEST_F(LalrNullable, ShouldReadThroughNullableNoTerminals) {
+    context.first();
+    auto lr1 = context.generalLr1();
+    auto lalr = context.generateLalr1();
+    expectMergedLookForward(context, lr1, lalr);
+    bool found = false;
+    for (auto &handler : lalr[0].ruleList()) {
+        if (handler.getProduction() == productions[4] && handler.getProduction().last() == empty) {
+            EXPECT_EQ(handler.getLookForward(), (set<Item>{b, c}));
+            found = true;
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
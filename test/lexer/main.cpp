@@ -0,0 +1,127 @@
+#include <gmock/gmock.h>
+#include "../../src/Context.h"
+#include "../../src/Lexer.h"
+#include "../../src/LrParser.h"
+#include "../lua/LuaGrammar.h"
+#include "../lua/LuaLexer.h"
+
+using namespace std;
+using namespace testing;
+
+static vector<int> symbolsOf(const vector<string> &names) {
+    vector<int> result{};
+    for (auto &name : names) {
+        result.push_back(Item{name, ItemType::Terminal}.getId());
+    }
+    return result;
+}
+
+TEST(Lexer, ShouldTakeTheLongestMatchThenTheEarlierRule) {
+    auto table = LexerGenerator{vector<TokenRule>{
+            TokenRule{"space", " +", true},
+            TokenRule{"if", "if", false},
+            TokenRule{"id", "[a-z]+", false},
+            TokenRule{"=", "=", false},
+            TokenRule{"==", "==", false},
+    }}.generate();
+    Lexer lexer{table};
+    vector<int> symbols{};
+    vector<LexToken> tokens{};
+    auto result = lexer.tokenize("if iffy ===", symbols, &tokens);
+    EXPECT_TRUE(result.complete);
+    EXPECT_EQ(result.tokens, 4);
+    EXPECT_EQ(symbols, symbolsOf({"if", "id", "==", "="}));
+    EXPECT_EQ(tokens[1].begin, 3);
+    EXPECT_EQ(tokens[1].end, 7);
+
+    symbols.clear();
+    result = lexer.tokenize("if x ? y", symbols);
+    EXPECT_FALSE(result.complete);
+    EXPECT_EQ(result.position, 5);
+    EXPECT_EQ(symbols, symbolsOf({"if", "id"}));
+}
+
+TEST(Lexer, ShouldMinimizeTheDfa) {
+    // the textbook dfa of (a|b)*abb has four states
+    auto table = LexerGenerator{vector<TokenRule>{TokenRule{"abb", "(a|b)*abb", false}}}.generate();
+    EXPECT_EQ(table.stateCount(), 4);
+    Lexer lexer{table};
+    vector<int> symbols{};
+    EXPECT_TRUE(lexer.tokenize("babbaabb", symbols).complete);
+    EXPECT_EQ(symbols, symbolsOf({"abb"}));
+    EXPECT_FALSE(lexer.tokenize("abba", symbols).complete);
+}
+
+TEST(Lexer, ShouldRejectBadPatterns) {
+    for (auto pattern : {"a(", "a)", "*a", "[b-a]", "[ab", "a\\", "\\xg0", "a|", "a*", "(b?)", ""}) {
+        EXPECT_THROW(LexerGenerator(vector<TokenRule>{TokenRule{"bad", pattern, false}}), runtime_error)
+                            << pattern;
+    }
+    EXPECT_NO_THROW(LexerGenerator(vector<TokenRule>{TokenRule{"good", "[]a-][^\\]]\\x41\\d\\w\\s.", false}}));
+}
+
+TEST(Lexer, VectorizedRunsShouldMatchTheByteByByteScan) {
+    auto rules = luaTokenRules();
+    auto table = LexerGenerator{rules}.generate();
+    string text{};
+    for (int i = 0; i < 50; i++) {
+        text += "local " + string(static_cast<size_t>(i * 3 + 1), 'x') + "_" + to_string(i) + string(i % 37, ' ') +
+                "= \"" + string(static_cast<size_t>(i * 5), 'y') + "\\\"\"" + string(i % 20, '\n') +
+                "-- " + string(static_cast<size_t>(i), '-') + "\n" + to_string(i * 1234567) + "..." + "\t";
+    }
+    Lexer lexer{table};
+    vector<int> vectorized{};
+    vector<LexToken> vectorizedTokens{};
+    auto vectorizedResult = lexer.tokenize(text.data(), text.data() + text.size(), vectorized, &vectorizedTokens);
+    lexer.setVectorized(false);
+    vector<int> scalar{};
+    vector<LexToken> scalarTokens{};
+    lexer.tokenize(text.data(), text.data() + text.size(), scalar, &scalarTokens);
+    EXPECT_TRUE(vectorizedResult.complete);
+    EXPECT_EQ(vectorizedResult.tokens, 50 * 6);
+    EXPECT_EQ(vectorized, scalar);
+    ASSERT_EQ(vectorizedTokens.size(), scalarTokens.size());
+    for (size_t i = 0; i < scalarTokens.size(); i++) {
+        EXPECT_EQ(vectorizedTokens[i].begin, scalarTokens[i].begin);
+        EXPECT_EQ(vectorizedTokens[i].end, scalarTokens[i].end);
+    }
+
+    // an unterminated string stops the scan at its quote either way
+    auto broken = text + "x = \"" + string(100, 'z');
+    for (auto enabled : {true, false}) {
+        lexer.setVectorized(enabled);
+        vector<int> symbols{};
+        auto result = lexer.tokenize(broken.data(), broken.data() + broken.size(), symbols);
+        EXPECT_FALSE(result.complete);
+        EXPECT_EQ(result.position, text.size() + 4);
+    }
+}
+
+TEST(Lexer, LuaTokensShouldBeTheTerminalsOfTheParser) {
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    auto states = context.generateLr1Parallel();
+    auto table = context.table(states);
+    LrParser parser{table, Item{"$", ItemType::Terminal}.getId()};
+    auto lexerTable = LexerGenerator{luaTokenRules()}.generate();
+    Lexer lexer{lexerTable};
+
+    string program = "local x = 0x1F -- the start\n"
+                     "while x do x = {y, \"s\\\"\", [1] = 2.5e3} end\n"
+                     "return x";
+    vector<int> symbols{};
+    auto result = lexer.tokenize(program, symbols);
+    ASSERT_TRUE(result.complete);
+    EXPECT_EQ(symbols.front(), lua.local.getId());
+    EXPECT_EQ(symbols[1], lua.name.getId());
+    EXPECT_EQ(symbols[3], lua.number_.getId());
+    for (auto symbol : symbols) {
+        EXPECT_NE(table.terminalColumn(symbol), -1) << Item{symbol}.getName();
+    }
+    EXPECT_TRUE(parser.parse(symbols).accepted);
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
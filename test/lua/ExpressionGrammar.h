@@ -0,0 +1,10 @@
+#ifndef EXPRESSION_GRAMMAR_H
+#define EXPRESSION_GRAMMAR_H
+
+// the left recursive expression grammar in the GrammarFile format, shared by the tests next to LuaGrammar.h.
+inline constexpr const char *expression = "S ::= E\n"
+                                          "E ::= E + T | T\n"
+                                          "T ::= T * F | F\n"
+                                          "F ::= ( E ) | i\n";
+
+#endif
@@ -0,0 +1,199 @@
+#ifndef LUA_GRAMMAR_H
+#define LUA_GRAMMAR_H
+
+#include "../../src/Context.h"
+
+// the lua 5.1 grammar described in README.md, shared by the lua test and the benchmarks.
+struct LuaGrammar {
+    Item empty{"000", ItemType::Terminal};
+    Item start{"start", ItemType::NoTerminal};
+    Item chunk{"#chunk", ItemType::NoTerminal};
+    Item reptstat{"#reptstat", ItemType::NoTerminal};
+    Item optbreak{"#optbreak", ItemType::NoTerminal};
+    Item reptlaststat{"#reptlaststat", ItemType::NoTerminal};
+    Item block{"#block", ItemType::NoTerminal};
+    Item stat{"#stat", ItemType::NoTerminal};
+    Item reptelseifexp{"#reptelseifexp", ItemType::NoTerminal};
+    Item optelseblock{"#optelseblock", ItemType::NoTerminal};
+    Item optexp{"#optexp", ItemType::NoTerminal};
+    Item opteqexplist1{"#opteqexplist1", ItemType::NoTerminal};
+    Item optexplist1{"#optexplist1", ItemType::NoTerminal};
+    Item laststat{"#laststat", ItemType::NoTerminal};
+    Item funcname{"#funcname", ItemType::NoTerminal};
+    Item reptdotname{"#reptdotname", ItemType::NoTerminal};
+    Item reptcommaname{"#reptcommaname", ItemType::NoTerminal};
+    Item optsemicolonname{"#optsemicolonname", ItemType::NoTerminal};
+    Item varlist1{"#varlist1", ItemType::NoTerminal};
+    Item reptcommavar{"#reptcommavar", ItemType::NoTerminal};
+    Item var{"#var", ItemType::NoTerminal};
+    Item namelist{"#namelist", ItemType::NoTerminal};
+    Item explist1{"#explist1", ItemType::NoTerminal};
+    Item reptexpcomma{"#reptexpcomma", ItemType::NoTerminal};
+    Item exp{"#exp", ItemType::NoTerminal};
+    Item prefixexp{"#prefixexp", ItemType::NoTerminal};
+    Item functioncall{"#functioncall", ItemType::NoTerminal};
+    Item args{"#args", ItemType::NoTerminal};
+    Item function_{"#function", ItemType::NoTerminal};
+    Item optparlist1{"#optparlist1", ItemType::NoTerminal};
+    Item funcbody{"#funcbody", ItemType::NoTerminal};
+    Item optcommadotdotdot{"#optcommadotdotdot", ItemType::NoTerminal};
+    Item parlist1{"#parlist1", ItemType::NoTerminal};
+    Item optfieldlist{"#optfieldlist", ItemType::NoTerminal};
+    Item tableconstructor{"#tableconstructor", ItemType::NoTerminal};
+    Item reptfieldsepfield{"#reptfieldsepfield", ItemType::NoTerminal};
+    Item optfieldsep{"#optfieldsep", ItemType::NoTerminal};
+    Item fieldlist{"#fieldlist", ItemType::NoTerminal};
+    Item field{"#field", ItemType::NoTerminal};
+    Item fieldsep{"#fieldsep", ItemType::NoTerminal};
+    Item binop{"#binop", ItemType::NoTerminal};
+    Item unop{"#unop", ItemType::NoTerminal};
+
+    Item brk{";", ItemType::Terminal};
+    Item eq{"=", ItemType::Terminal};
+    Item do_{"do", ItemType::Terminal};
+    Item end_{"end", ItemType::Terminal};
+    Item while_{"while", ItemType::Terminal};
+    Item repeat{"repeat", ItemType::Terminal};
+    Item until{"until", ItemType::Terminal};
+    Item if_{"if", ItemType::Terminal};
+    Item then_{"then", ItemType::Terminal};
+    Item for_{"for", ItemType::Terminal};
+    Item name{"name", ItemType::Terminal};
+    Item comma{",", ItemType::Terminal};
+    Item in_{"in", ItemType::Terminal};
+    Item local{"local", ItemType::Terminal};
+    Item elseif_{"elseif", ItemType::Terminal};
+    Item else_{"else", ItemType::Terminal};
+    Item return_{"return", ItemType::Terminal};
+    Item break_{"break", ItemType::Terminal};
+    Item dot{".", ItemType::Terminal};
+    Item semicolon{":", ItemType::Terminal};
+    Item r_seq_bracket{"]", ItemType::Terminal};
+    Item l_seq_bracket{"[", ItemType::Terminal};
+    Item nil{"nil", ItemType::Terminal};
+    Item false_{"false", ItemType::Terminal};
+    Item true_{"true", ItemType::Terminal};
+    Item number_{"number", ItemType::Terminal};
+    Item string_{"string", ItemType::Terminal};
+    Item dotdotdot{"...", ItemType::Terminal};
+    Item l_bracket{"(", ItemType::Terminal};
+    Item r_bracket{")", ItemType::Terminal};
+    Item l_ang_bracket{"{", ItemType::Terminal};
+    Item r_ang_bracket{"}", ItemType::Terminal};
+    Item plus{"+", ItemType::Terminal};
+    Item minus{"-", ItemType::Terminal};
+    Item mul{"*", ItemType::Terminal};
+    Item divi{"/", ItemType::Terminal};
+    Item caret{"^", ItemType::Terminal};
+    Item percent{"%", ItemType::Terminal};
+    Item dotdot{"..", ItemType::Terminal};
+    Item lt{"<", ItemType::Terminal};
+    Item lte{"<=", ItemType::Terminal};
+    Item gt{">", ItemType::Terminal};
+    Item gte{">=", ItemType::Terminal};
+    Item ieq{"==", ItemType::Terminal};
+    Item neq{"~=", ItemType::Terminal};
+    Item and_{"and", ItemType::Terminal};
+    Item or_{"or", ItemType::Terminal};
+    Item pound{"#", ItemType::Terminal};
+    Item not_{"not", ItemType::Terminal};
+    Item func{"function", ItemType::Terminal};
+
+    std::vector<Production> productionList{
+            Production{start, std::vector<Item>{chunk}},
+            Production{chunk, std::vector<Item>{reptstat, reptlaststat}},
+            Production{reptstat, std::vector<Item>{empty}},
+            Production{reptstat, std::vector<Item>{reptstat, stat, optbreak}},
+            Production{optbreak, std::vector<Item>{empty}},
+            Production{optbreak, std::vector<Item>{brk}},
+            Production{reptlaststat, std::vector<Item>{empty}},
+            Production{reptlaststat, std::vector<Item>{laststat, optbreak}},
+            Production{block, std::vector<Item>{chunk}},
+            Production{stat, std::vector<Item>{varlist1, eq, explist1}},
+            Production{stat, std::vector<Item>{functioncall}},
+            Production{stat, std::vector<Item>{do_, block, end_}},
+            Production{stat, std::vector<Item>{while_, exp, do_, block, end_}},
+            Production{stat, std::vector<Item>{repeat, block, until, exp}},
+            Production{stat, std::vector<Item>{if_, exp, then_, block, reptelseifexp, optelseblock, end_}},
+            Production{stat, std::vector<Item>{for_, name, eq, exp, comma, exp, optexp, do_, block, end_}},
+            Production{stat, std::vector<Item>{for_, namelist, in_, explist1, do_, block, end_}},
+            Production{stat, std::vector<Item>{function_, funcname, funcbody}},
+            Production{stat, std::vector<Item>{local, function_, name, funcbody}},
+            Production{stat, std::vector<Item>{local, namelist, opteqexplist1}},
+            Production{reptelseifexp, std::vector<Item>{empty}},
+            Production{reptelseifexp, std::vector<Item>{reptelseifexp, elseif_, exp, then_, block}},
+            Production{optelseblock, std::vector<Item>{empty}},
+            Production{optelseblock, std::vector<Item>{else_, block}},
+            Production{optexp, std::vector<Item>{empty}},
+            Production{optexp, std::vector<Item>{brk, exp}},
+            Production{opteqexplist1, std::vector<Item>{empty}},
+            Production{opteqexplist1, std::vector<Item>{eq, explist1}},
+            Production{optexplist1, std::vector<Item>{empty}},
+            Production{optexplist1, std::vector<Item>{explist1}},
+            Production{laststat, std::vector<Item>{return_, optexplist1}},
+            Production{laststat, std::vector<Item>{break_}},
+            Production{funcname, std::vector<Item>{name, reptdotname, optsemicolonname}},
+            Production{reptdotname, std::vector<Item>{empty}},
+            Production{reptdotname, std::vector<Item>{reptdotname, dot, name}},
+            Production{reptcommaname, std::vector<Item>{empty}},
+            Production{reptcommaname, std::vector<Item>{reptcommaname, comma, name}},
+            Production{optsemicolonname, std::vector<Item>{empty}},
+            Production{optsemicolonname, std::vector<Item>{semicolon, name}},
+            Production{varlist1, std::vector<Item>{var, reptcommavar}},
+            Production{reptcommavar, std::vector<Item>{empty}},
+            Production{reptcommavar, std::vector<Item>{reptcommavar, var}},
+            Production{var, std::vector<Item>{name}},
+            Production{var, std::vector<Item>{prefixexp, l_seq_bracket, exp, r_seq_bracket}},
+            Production{var, std::vector<Item>{prefixexp, dot, name}},
+            Production{namelist, std::vector<Item>{name, reptcommaname}},
+            Production{explist1, std::vector<Item>{reptexpcomma, exp}},
+            Production{reptexpcomma, std::vector<Item>{empty}},
+            Production{reptexpcomma, std::vector<Item>{reptexpcomma, exp, comma}},
+            Production{exp, std::vector<Item>{nil}},
+            Production{exp, std::vector<Item>{false_}},
+            Production{exp, std::vector<Item>{true_}},
+            Production{exp, std::vector<Item>{number_}},
+            Production{exp, std::vector<Item>{string_}},
+            Production{exp, std::vector<Item>{dotdotdot}},
+            Production{exp, std::vector<Item>{function_}},
+            Production{exp, std::vector<Item>{prefixexp}},
+            Production{exp, std::vector<Item>{tableconstructor}},
+            Production{exp, std::vector<Item>{exp, binop, exp}},
+            Production{exp, std::vector<Item>{unop, exp}},
+            Production{prefixexp, std::vector<Item>{var}},
+            Production{prefixexp, std::vector<Item>{functioncall}},
+            Production{prefixexp, std::vector<Item>{l_bracket, exp, r_bracket}},
+            Production{functioncall, std::vector<Item>{prefixexp, args}},
+            Production{functioncall, std::vector<Item>{prefixexp, semicolon, name, args}},
+            Production{args, std::vector<Item>{l_bracket, optexplist1, r_bracket}},
+            Production{args, std::vector<Item>{tableconstructor, string_}},
+            Production{function_, std::vector<Item>{func, funcbody}},
+            Production{optparlist1, std::vector<Item>{empty}},
+            Production{optparlist1, std::vector<Item>{parlist1}},
+            Production{funcbody, std::vector<Item>{l_bracket, parlist1, r_bracket, block, end_}},
+            Production{optcommadotdotdot, std::vector<Item>{empty}},
+            Production{optcommadotdotdot, std::vector<Item>{comma, dotdotdot}},
+            Production{parlist1, std::vector<Item>{namelist, optcommadotdotdot}},
+            Production{parlist1, std::vector<Item>{dotdotdot}},
+            Production{optfieldlist, std::vector<Item>{empty}},
+            Production{optfieldlist, std::vector<Item>{fieldlist}},
+            Production{tableconstructor, std::vector<Item>{l_ang_bracket, optfieldlist, r_ang_bracket}},
+            Production{reptfieldsepfield, std::vector<Item>{empty}},
+            Production{reptfieldsepfield, std::vector<Item>{reptfieldsepfield, fieldsep, field}},
+            Production{optfieldsep, std::vector<Item>{empty}},
+            Production{optfieldsep, std::vector<Item>{fieldsep}},
+            Production{fieldlist, std::vector<Item>{field, reptfieldsepfield, optfieldsep}},
+            Production{field, std::vector<Item>{l_seq_bracket, exp, r_seq_bracket, eq, exp}},
+            Production{field, std::vector<Item>{name, eq, exp}},
+            Production{field, std::vector<Item>{exp}},
+            Production{fieldsep, std::vector<Item>{comma}},
+            Production{fieldsep, std::vector<Item>{brk}},
+            Production{binop,
+                       std::vector<Item>{plus, minus, mul, divi, caret, percent, dotdot, lt, lte, gt, gte, ieq, neq,
+                                         and_, or_}},
+            Production{unop, std::vector<Item>{minus, not_, pound}},
+
+    };
+};
+
+#endif
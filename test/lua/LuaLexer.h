@@ -0,0 +1,31 @@
+#ifndef LUA_LEXER_H
+#define LUA_LEXER_H
+
+#include "../../src/LexerGenerator.h"
+
+// the tokens of LuaGrammar.h, the names are its terminal names. the keywords come before name
+// so they win between matches of the same length
+inline std::vector<TokenRule> luaTokenRules() {
+    std::vector<TokenRule> rules{
+            TokenRule{"space", "[ \\t\\r\\n]+", true},
+            TokenRule{"comment", "--[^\\n]*", true},
+    };
+    for (auto keyword : {"and", "break", "do", "else", "elseif", "end", "false", "for", "function", "if", "in",
+                         "local", "nil", "not", "or", "repeat", "return", "then", "true", "until", "while"}) {
+        rules.push_back(TokenRule{keyword, keyword, false});
+    }
+    for (auto op : {"+", "-", "*", "/", "%", "^", "#", "==", "~=", "<=", ">=", "<", ">", "=", "(", ")", "{", "}",
+                    "[", "]", ";", ":", ",", ".", "..", "..."}) {
+        std::string pattern{};
+        for (auto c = op; *c != '\0'; c++) {
+            pattern += std::string{"\\"} + *c;
+        }
+        rules.push_back(TokenRule{op, pattern, false});
+    }
+    rules.push_back(TokenRule{"name", "[A-Za-z_][A-Za-z0-9_]*", false});
+    rules.push_back(TokenRule{"number", "[0-9]+(\\.[0-9]+)?([eE][-+]?[0-9]+)?|0[xX][0-9a-fA-F]+", false});
+    rules.push_back(TokenRule{"string", "\"([^\"\\\\\\n]|\\\\.)*\"|'([^'\\\\\\n]|\\\\.)*'", false});
+    return rules;
+}
+
+#endif
@@ -0,0 +1,232 @@
+#include <gmock/gmock.h>
+#include "../../src/Context.h"
+#include "../../src/GrammarFile.h"
+#include "../../src/LrParser.h"
+#include "../../src/TableFile.h"
+#include "../../src/TableOptimizer.h"
+#include "../lua/ExpressionGrammar.h"
+#include "../lua/LuaGrammar.h"
+
+using namespace std;
+using namespace testing;
+
+static int eof() {
+    return Item{"$", ItemType::Terminal}.getId();
+}
+
+static vector<int> tokens(const string &text) {
+    vector<int> result{};
+    for (auto c : text) {
+        if (c != ' ') {
+            result.push_back(Item{string{c}, ItemType::Terminal}.getId());
+        }
+    }
+    return result;
+}
+
+// the productions reduced by a parse, in order
+static vector<int> reduces(const ParseTable &table, const vector<int> &input, ParseResult &result) {
+    LrParser parser{table, eof()};
+    vector<int> productions{};
+    parser.onReduce([&productions](int production, size_t, size_t) { productions.push_back(production); });
+    result = parser.parse(input);
+    return productions;
+}
+
+// every sequence up to length over the terminals is accepted by both tables or rejected at the same token
+static void expectSameLanguage(const ParseTable &table, const ParseTable &optimized, size_t length) {
+    LrParser parser{table, eof()};
+    LrParser optimizedParser{optimized, eof()};
+    vector<int> alphabet{};
+    for (auto symbol : table.terminals()) {
+        if (symbol != eof()) {
+            alphabet.push_back(symbol);
+        }
+    }
+    vector<size_t> digits{};
+    size_t accepted = 0;
+    for (size_t n = 0; n <= length; n++) {
+        digits.assign(n, 0);
+        while (true) {
+            vector<int> input{};
+            for (auto digit : digits) {
+                input.push_back(alphabet[digit]);
+            }
+            auto expected = parser.parse(input);
+            auto result = optimizedParser.parse(input);
+            ASSERT_EQ(result.accepted, expected.accepted);
+            ASSERT_EQ(result.position, expected.position);
+            ASSERT_EQ(result.shifts, expected.shifts);
+            accepted += result.accepted;
+            size_t i = 0;
+            for (; i < n && ++digits[i] == alphabet.size(); i++) {
+                digits[i] = 0;
+            }
+            if (i == n) {
+                break;
+            }
+        }
+    }
+    EXPECT_GT(accepted, 0);
+}
+
+TEST(Optimize, DefaultReductionsShouldEmptyTheReduceCells) {
+    auto context = GrammarFile::parse(expression).context();
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    auto optimized = table;
+    auto savings = TableOptimizer{optimized}.addDefaultReductions();
+    EXPECT_GT(savings.defaultReductions, 0);
+    EXPECT_EQ(savings.before.actionEntries - savings.after.actionEntries, savings.replacedReduces);
+    EXPECT_EQ(savings.after.defaultEntries, savings.defaultReductions);
+    EXPECT_EQ(savings.statesAfter, savings.statesBefore);
+    for (int state = 0; state < static_cast<int>(optimized.stateCount()); state++) {
+        for (int column = 0; column < static_cast<int>(optimized.terminalCount()); column++) {
+            if (optimized.defaultReduction(state) != -1) {
+                EXPECT_NE(optimized.action(state, column),
+                          (ParseAction{ActionType::Reduce, optimized.defaultReduction(state)}));
+            }
+        }
+    }
+
+    ParseResult expected{};
+    ParseResult result{};
+    auto input = tokens("( i + i ) * i");
+    EXPECT_EQ(reduces(optimized, input, result), reduces(table, input, expected));
+    EXPECT_TRUE(result.accepted);
+    expectSameLanguage(table, optimized, 6);
+}
+
+TEST(Optimize, NonAssocCellsShouldStayErrors) {
+    auto context = GrammarFile::parse("%nonassoc <\n"
+                                      "E ::= E < E | i\n").context();
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    auto optimized = table;
+    TableOptimizer{optimized}.addDefaultReductions();
+    size_t blocked = 0;
+    for (int state = 0; state < static_cast<int>(optimized.stateCount()); state++) {
+        if (optimized.hasExplicitError(state)) {
+            blocked++;
+            EXPECT_EQ(optimized.defaultReduction(state), -1);
+        }
+    }
+    EXPECT_GT(blocked, 0);
+    ParseResult result{};
+    reduces(optimized, tokens("i < i < i"), result);
+    EXPECT_FALSE(result.accepted);
+    EXPECT_EQ(result.position, 3);
+    expectSameLanguage(table, optimized, 5);
+
+    // the state after B reduces by A -> B and has a %nonassoc error on t, so it is not bypassed
+    auto unitContext = GrammarFile::parse("%nonassoc t\n"
+                                          "S ::= A t a | A u a | B t b\n"
+                                          "A ::= B %prec t\n"
+                                          "B ::= c\n").context();
+    auto unitStates = unitContext.generalLr1();
+    auto unitTable = unitContext.table(unitStates);
+    for (bool defaults : {false, true}) {
+        auto bypassed = unitTable;
+        TableOptimizer optimizer{bypassed};
+        if (defaults) {
+            optimizer.addDefaultReductions();
+        }
+        EXPECT_EQ(optimizer.eliminateUnitRules().bypassedGotos, 0);
+        reduces(bypassed, tokens("c t a"), result);
+        EXPECT_FALSE(result.accepted);
+        reduces(bypassed, tokens("c u a"), result);
+        EXPECT_TRUE(result.accepted);
+        expectSameLanguage(unitTable, bypassed, 4);
+    }
+}
+
+TEST(Optimize, UnitRulesShouldBeBypassed) {
+    auto context = GrammarFile::parse(expression).context();
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    // E -> T and T -> F
+    int et = context.getGrammar().findProduction(Production{Item{"E", ItemType::NoTerminal},
+                                                            {Item{"T", ItemType::NoTerminal}}});
+    int tf = context.getGrammar().findProduction(Production{Item{"T", ItemType::NoTerminal},
+                                                            {Item{"F", ItemType::NoTerminal}}});
+    ASSERT_NE(et, -1);
+    ASSERT_NE(tf, -1);
+
+    for (bool defaults : {false, true}) {
+        auto optimized = table;
+        TableOptimizer optimizer{optimized};
+        if (defaults) {
+            optimizer.addDefaultReductions();
+        }
+        auto savings = optimizer.eliminateUnitRules();
+        EXPECT_GT(savings.bypassedGotos, 0);
+        EXPECT_GE(savings.bypassedReductions, savings.bypassedGotos);
+        EXPECT_LT(savings.statesAfter, savings.statesBefore);
+        EXPECT_EQ(optimized.stateCount(), savings.statesAfter);
+        EXPECT_LT(savings.after.actionBytes, savings.before.actionBytes);
+
+        ParseResult expected{};
+        ParseResult result{};
+        auto input = tokens("i + i * ( i )");
+        auto plain = reduces(table, input, expected);
+        auto bypassed = reduces(optimized, input, result);
+        EXPECT_TRUE(result.accepted);
+        // the state after T also shifts *, so E -> T is reduced, the one after F only reduces T -> F
+        EXPECT_THAT(plain, Contains(tf));
+        EXPECT_THAT(bypassed, Not(Contains(tf)));
+        EXPECT_THAT(bypassed, Contains(et));
+        EXPECT_LT(result.reductions, expected.reductions);
+        expectSameLanguage(table, optimized, 6);
+    }
+
+    // a production with a semantic action is still reduced
+    auto kept = table;
+    EXPECT_EQ(TableOptimizer{kept}.eliminateUnitRules({tf}).bypassedGotos, 0);
+    ParseResult result{};
+    EXPECT_THAT(reduces(kept, tokens("i + i"), result), Contains(tf));
+    EXPECT_TRUE(result.accepted);
+}
+
+TEST(Optimize, LuaShouldParseWithFewerReductionsFromAMappedFile) {
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    auto optimized = table;
+    TableOptimizer optimizer{optimized};
+    auto defaults = optimizer.addDefaultReductions();
+    auto units = optimizer.eliminateUnitRules();
+    EXPECT_LT(defaults.after.actionEntries * 2, defaults.before.actionEntries);
+    EXPECT_LT(units.statesAfter, units.statesBefore);
+
+    auto path = TempDir() + "optimized.lr1t";
+    TableFile::write(optimized, eof(), path);
+    TableFile file{path};
+    // local x = 1 while x do x = {y, "s"} end return x
+    vector<Item> program{lua.local, lua.name, lua.eq, lua.number_,
+                         lua.while_, lua.name, lua.do_,
+                         lua.name, lua.eq, lua.l_ang_bracket, lua.name, lua.comma, lua.string_, lua.r_ang_bracket,
+                         lua.end_,
+                         lua.return_, lua.name};
+    vector<int> input{};
+    for (auto &item : program) {
+        input.push_back(item.getId());
+    }
+    ParseResult expected{};
+    reduces(table, input, expected);
+    LrParser parser{file.view(), file.eofSymbol()};
+    auto result = parser.parse(input);
+    EXPECT_TRUE(expected.accepted);
+    EXPECT_TRUE(result.accepted);
+    EXPECT_EQ(result.shifts, expected.shifts);
+    EXPECT_LT(result.reductions, expected.reductions);
+
+    input.insert(input.begin() + 3, lua.eq.getId());
+    LrParser plain{table, eof()};
+    EXPECT_EQ(parser.parse(input).position, plain.parse(input).position);
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,175 @@
+#include <gmock/gmock.h>
+#include "../../src/Context.h"
+#include "../../src/LrParser.h"
+#include "../../src/TableFile.h"
+#include <cstring>
+#include <fstream>
+#include "../lua/LuaGrammar.h"
+
+using namespace std;
+using namespace testing;
+
+class Parser : public Test {
+public:
+    Item S_{"S_", ItemType::NoTerminal};
+    Item S{"S", ItemType::NoTerminal};
+    Item C{"C", ItemType::NoTerminal};
+    Item c{"c", ItemType::Terminal};
+    Item d{"d", ItemType::Terminal};
+    Item eof{"$", ItemType::Terminal};
+    vector<Production> productions{
+            Production{S_, vector<Item>{S}},
+            Production{S, vector<Item>{C, C}},
+            Production{C, vector<Item>{c, C}},
+            Production{C, vector<Item>{d}},
+    };
+
+    Context context{productions, productions[0]};
+};
+
+TEST_F(Parser, ShouldReduceInPostOrder) {
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    LrParser parser{table, eof.getId()};
+    vector<tuple<int, size_t, size_t>> reduces{};
+    parser.onReduce([&reduces](int production, size_t begin, size_t end) {
+        reduces.emplace_back(production, begin, end);
+    });
+    auto result = parser.parse(vector<int>{c.getId(), d.getId(), d.getId()});
+    EXPECT_TRUE(result.accepted);
+    EXPECT_EQ(result.position, 3);
+    EXPECT_EQ(result.shifts, 3);
+    EXPECT_EQ(result.reductions, 4);
+    EXPECT_EQ(reduces, (vector<tuple<int, size_t, size_t>>{
+            {3, 1, 2},
+            {2, 0, 2},
+            {3, 2, 3},
+            {1, 0, 3},
+    }));
+}
+
+TEST_F(Parser, ShouldStopAtTheFirstUnexpectedToken) {
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    LrParser parser{table, eof.getId(), 1};
+    auto missing = parser.parse(vector<int>{c.getId(), d.getId()});
+    EXPECT_FALSE(missing.accepted);
+    EXPECT_EQ(missing.position, 2);
+    auto extra = parser.parse(vector<int>{d.getId(), d.getId(), d.getId()});
+    EXPECT_FALSE(extra.accepted);
+    EXPECT_EQ(extra.position, 2);
+    auto unknown = parser.parse(vector<int>{S.getId()});
+    EXPECT_FALSE(unknown.accepted);
+    EXPECT_EQ(unknown.position, 0);
+
+    // the stack grows past its initial capacity once and is reused afterwards
+    vector<int> deep(100, c.getId());
+    deep.push_back(d.getId());
+    deep.push_back(d.getId());
+    EXPECT_TRUE(parser.parse(deep).accepted);
+    auto capacity = parser.stackCapacity();
+    EXPECT_GE(capacity, 101);
+    EXPECT_TRUE(parser.parse(deep).accepted);
+    EXPECT_EQ(parser.stackCapacity(), capacity);
+    EXPECT_THROW((LrParser{table, S.getId()}), runtime_error);
+}
+
+TEST_F(Parser, MappedTableShouldParseLikeTheGeneratedOne) {
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    auto path = TempDir() + "goto.lr1t";
+    TableFile::write(table, eof.getId(), path);
+    TableFile file{path};
+    EXPECT_EQ(file.header().version, TableFile::version);
+    EXPECT_EQ(file.eofSymbol(), eof.getId());
+    auto view = file.view();
+    ASSERT_EQ(view.states, table.stateCount());
+    EXPECT_EQ(0, memcmp(view.actions, table.actionData().data(), table.actionData().size() * sizeof(int32_t)));
+    EXPECT_EQ(0, memcmp(view.gotos, table.gotoData().data(), table.gotoData().size() * sizeof(int32_t)));
+    EXPECT_EQ(view.terminalColumn(d.getId()), table.terminalColumn(d.getId()));
+    EXPECT_EQ(view.terminalColumn(S.getId()), -1);
+    for (int column = 0; column < static_cast<int>(table.noTerminalCount()); column++) {
+        EXPECT_EQ(file.noTerminalName(column), Item{table.noTerminals()[column]}.getName());
+    }
+
+    LrParser parser{view, file.eofSymbol()};
+    EXPECT_TRUE(parser.parse(vector<int>{c.getId(), d.getId(), d.getId()}).accepted);
+    EXPECT_FALSE(parser.parse(vector<int>{c.getId(), d.getId()}).accepted);
+
+    // a cell pointing out of the table is rejected
+    string bytes{};
+    {
+        ifstream in{path, ios::binary};
+        bytes.assign(istreambuf_iterator<char>{in}, istreambuf_iterator<char>{});
+    }
+    auto header = file.header();
+    auto damaged = [&](uint64_t offset, int32_t cell) {
+        auto copy = bytes;
+        memcpy(&copy[offset], &cell, sizeof(cell));
+        ofstream out{path, ios::binary | ios::trunc};
+        out.write(copy.data(), static_cast<streamsize>(copy.size()));
+    };
+    auto stateCount = static_cast<int>(header.states);
+    auto productions = static_cast<int>(header.productions);
+    vector<pair<uint64_t, int32_t>> cells{
+            {header.actionOffset, ParseTable::encode(ParseAction{ActionType::Shift, stateCount})},
+            {header.actionOffset, ParseTable::encode(ParseAction{ActionType::Reduce, productions})},
+            {header.actionOffset, ParseTable::encode(ParseAction{ActionType::Reduce, -1})},
+            {header.gotoOffset, stateCount},
+            {header.gotoOffset, -2},
+            {header.productionOffset, static_cast<int32_t>(header.noTerminals)},
+            {header.productionOffset + sizeof(int32_t), -1},
+            {header.defaultOffset, productions},
+            {header.defaultOffset, -2},
+    };
+    for (auto &cell : cells) {
+        damaged(cell.first, cell.second);
+        EXPECT_THROW(TableFile{path}, runtime_error) << cell.first << " " << cell.second;
+    }
+    damaged(header.defaultOffset, productions - 1);
+    EXPECT_NO_THROW(TableFile{path});
+
+    // a truncated or foreign file is rejected
+    {
+        std::ofstream out{path, ios::binary | ios::trunc};
+        out << "LR1T";
+    }
+    EXPECT_THROW(TableFile{path}, runtime_error);
+    EXPECT_THROW(TableFile{path + ".missing"}, runtime_error);
+}
+
+TEST(LuaParser, ShouldParseStatements) {
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    auto states = context.generateLr1Parallel();
+    auto table = context.table(states);
+    LrParser parser{table, Item{"$", ItemType::Terminal}.getId()};
+    size_t emptyReduces = 0;
+    parser.onReduce([&emptyReduces](int, size_t begin, size_t end) {
+        emptyReduces += begin == end;
+    });
+    // local x = 1 while x do x = {y, "s"} end return x
+    vector<Item> program{lua.local, lua.name, lua.eq, lua.number_,
+                         lua.while_, lua.name, lua.do_,
+                         lua.name, lua.eq, lua.l_ang_bracket, lua.name, lua.comma, lua.string_, lua.r_ang_bracket,
+                         lua.end_,
+                         lua.return_, lua.name};
+    vector<int> tokens{};
+    for (auto &item : program) {
+        tokens.push_back(item.getId());
+    }
+    auto result = parser.parse(tokens);
+    EXPECT_TRUE(result.accepted);
+    EXPECT_EQ(result.shifts, tokens.size());
+    EXPECT_GT(emptyReduces, 0);
+
+    tokens.insert(tokens.begin() + 4, lua.eq.getId());
+    result = parser.parse(tokens);
+    EXPECT_FALSE(result.accepted);
+    EXPECT_EQ(result.position, 4);
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
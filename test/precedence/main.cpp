@@ -0,0 +1,203 @@
+#include <gmock/gmock.h>
+#include "../../src/GrammarFile.h"
+#include "../../src/LrParser.h"
+#include <sstream>
+
+using namespace std;
+using namespace testing;
+
+static const char *ambiguous = "S ::= E\n"
+                               "E ::= E + E | E - E | E * E | E / E | E ^ E | E < E\n"
+                               "   | - E %prec NEG | ( E ) | i\n"
+                               "%nonassoc <\n"
+                               "%left + -\n"
+                               "%left * /\n"
+                               "%right ^\n"
+                               "%left NEG\n";
+
+static const char *layered = "S ::= C\n"
+                             "C ::= E < E | E\n"
+                             "E ::= E + T | E - T | T\n"
+                             "T ::= T * U | T / U | U\n"
+                             "U ::= - U | P\n"
+                             "P ::= F ^ P | F\n"
+                             "F ::= ( C ) | i\n";
+
+static vector<int> tokensOf(const string &text) {
+    istringstream in{text};
+    vector<int> result{};
+    for (string name; in >> name;) {
+        result.push_back(Item{name, ItemType::Terminal}.getId());
+    }
+    return result;
+}
+
+// the reduced productions of a parse written as a parenthesized expression, i for the leaves
+class TreePrinter {
+public:
+    TreePrinter(const GrammarFile &grammarRef, LrParser &parser) : grammar(grammarRef) {
+        parser.onReduce([this](int production, size_t, size_t) {
+            auto &p = grammar.productions()[production];
+            vector<string> children{};
+            for (auto &item : p) {
+                if (item.isNoTerminal()) {
+                    children.insert(children.begin(), stack.back());
+                    stack.pop_back();
+                }
+            }
+            string text{};
+            size_t child = 0;
+            for (auto &item : p) {
+                text += item.isNoTerminal() ? children[child++] : item.getName();
+            }
+            if (p.begin()->getName() == "(") {
+                stack.push_back(children.front());
+            } else {
+                stack.push_back(p.size() > 1 ? "(" + text + ")" : text);
+            }
+        });
+    }
+
+    string last() {
+        return stack.empty() ? string{} : stack.back();
+    }
+
+    void clear() {
+        stack.clear();
+    }
+
+private:
+    const GrammarFile &grammar;
+    vector<string> stack;
+};
+
+TEST(Precedence, ShouldResolveTheConflictsOfAnAmbiguousGrammar) {
+    auto grammar = GrammarFile::parse(ambiguous);
+    auto context = grammar.context();
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    EXPECT_TRUE(context.getConflicts().empty());
+    EXPECT_GT(context.getResolvedConflicts(), 0);
+
+    LrParser parser{table, Item{"$", ItemType::Terminal}.getId()};
+    TreePrinter tree{grammar, parser};
+    auto treeOf = [&](const string &text) {
+        tree.clear();
+        return parser.parse(tokensOf(text)).accepted ? tree.last() : string{"error"};
+    };
+    EXPECT_EQ(treeOf("i + i * i"), "(i+(i*i))");
+    EXPECT_EQ(treeOf("i - i - i"), "((i-i)-i)");
+    EXPECT_EQ(treeOf("i ^ i ^ i"), "(i^(i^i))");
+    EXPECT_EQ(treeOf("- i ^ i * i"), "(((-i)^i)*i)");
+    EXPECT_EQ(treeOf("- i * i"), "((-i)*i)");
+    EXPECT_EQ(treeOf("( i + i ) * i < i"), "(((i+i)*i)<i)");
+    EXPECT_EQ(treeOf("i < i < i"), "error");
+
+    // the same levels declared through the api give the same table
+    vector<Production> productions{grammar.productions()};
+    Context declared{productions, productions[0]};
+    declared.declarePrecedence(Associativity::NonAssoc, {Item{"<", ItemType::Terminal}});
+    declared.declarePrecedence(Associativity::Left, {Item{"+", ItemType::Terminal}, Item{"-", ItemType::Terminal}});
+    declared.declarePrecedence(Associativity::Left, {Item{"*", ItemType::Terminal}, Item{"/", ItemType::Terminal}});
+    declared.declarePrecedence(Associativity::Right, {Item{"^", ItemType::Terminal}});
+    declared.declarePrecedence(Associativity::Left, {Item{"NEG", ItemType::Terminal}});
+    declared.setPrecedence(productions[7], Item{"NEG", ItemType::Terminal});
+    auto declaredStates = declared.generalLr1();
+    EXPECT_EQ(declared.table(declaredStates, 3).actionData(), table.actionData());
+    EXPECT_THROW(declared.setPrecedence(Production{Item{"E", ItemType::NoTerminal}, {Item{"i", ItemType::Terminal}}},
+                                        Item{"E", ItemType::NoTerminal}), runtime_error);
+    EXPECT_THROW(declared.setPrecedence(Production{Item{"E", ItemType::NoTerminal}, {Item{"NEG", ItemType::Terminal}}},
+                                        Item{"NEG", ItemType::Terminal}), runtime_error);
+}
+
+TEST(Precedence, ShouldNeedFewerStatesAndReductionsThanTheLayeredGrammar) {
+    auto compact = GrammarFile::parse(ambiguous);
+    auto compactContext = compact.context();
+    auto compactStates = compactContext.generalLr1();
+    auto compactTable = compactContext.table(compactStates);
+    auto layers = GrammarFile::parse(layered);
+    auto layeredContext = layers.context();
+    auto layeredStates = layeredContext.generalLr1();
+    auto layeredTable = layeredContext.table(layeredStates);
+    EXPECT_TRUE(layeredContext.getConflicts().empty());
+    EXPECT_LT(compactStates.size(), layeredStates.size());
+
+    auto eof = Item{"$", ItemType::Terminal}.getId();
+    LrParser compactParser{compactTable, eof};
+    LrParser layeredParser{layeredTable, eof};
+    auto tokens = tokensOf("i + i * ( i - i ) / i ^ i < - i");
+    auto compactResult = compactParser.parse(tokens);
+    auto layeredResult = layeredParser.parse(tokens);
+    EXPECT_TRUE(compactResult.accepted);
+    EXPECT_TRUE(layeredResult.accepted);
+    EXPECT_LT(compactResult.reductions, layeredResult.reductions);
+}
+
+TEST(Precedence, UnresolvedConflictsShouldPreferTheShiftAndBeReported) {
+    auto grammar = GrammarFile::parse("S ::= T\n"
+                                      "T ::= if c T | if c T else T | x\n");
+    auto context = grammar.context();
+    auto states = context.generalLr1();
+    auto table = context.table(states);
+    ASSERT_FALSE(context.getConflicts().empty());
+    EXPECT_EQ(context.getResolvedConflicts(), 0);
+    for (auto &conflict : context.getConflicts()) {
+        EXPECT_EQ(Item{conflict.symbol}.getName(), "else");
+        EXPECT_EQ(conflict.first.type, ActionType::Shift);
+        EXPECT_EQ(conflict.second.type, ActionType::Reduce);
+        EXPECT_EQ(table.action(conflict.state, table.terminalColumn(conflict.symbol)), conflict.first);
+    }
+
+    // giving else the tighter level decides the conflict the same way
+    auto declared = GrammarFile::parse("S ::= T\n"
+                                       "T ::= if c T %prec then | if c T else T | x\n"
+                                       "%right then\n"
+                                       "%right else\n");
+    auto declaredContext = declared.context();
+    auto declaredStates = declaredContext.generalLr1();
+    EXPECT_EQ(declaredContext.table(declaredStates).actionData(), table.actionData());
+    EXPECT_TRUE(declaredContext.getConflicts().empty());
+    EXPECT_EQ(declaredContext.getResolvedConflicts(), context.getConflicts().size());
+}
+
+TEST(Precedence, ReduceReduceConflictsShouldBeDecidedBeforeTheShift) {
+    // on t after c the lowest production X wins over Y, then t binds tighter than X so t is shifted
+    for (auto rules : {"S ::= X t | Y t | c t z\n", "S ::= Y t | c t z | X t\n"}) {
+        auto grammar = GrammarFile::parse(string{rules} +
+                                          "X ::= c %prec a\n"
+                                          "Y ::= c %prec b\n"
+                                          "%left a\n"
+                                          "%left t\n"
+                                          "%left b\n");
+        auto context = grammar.context();
+        auto states = context.generalLr1();
+        auto table = context.table(states);
+        EXPECT_EQ(context.getResolvedConflicts(), 1);
+        ASSERT_EQ(context.getConflicts().size(), 1);
+        auto &conflict = context.getConflicts().front();
+        EXPECT_EQ(Item{conflict.symbol}.getName(), "t");
+        EXPECT_EQ(conflict.first.type, ActionType::Shift);
+        EXPECT_EQ(conflict.second.type, ActionType::Reduce);
+        EXPECT_EQ(grammar.productions()[conflict.second.value].getItem().getName(), "Y");
+        EXPECT_EQ(table.action(conflict.state, table.terminalColumn(conflict.symbol)), conflict.first);
+
+        LrParser parser{table, Item{"$", ItemType::Terminal}.getId()};
+        EXPECT_TRUE(parser.parse(tokensOf("c t z")).accepted);
+        EXPECT_FALSE(parser.parse(tokensOf("c t")).accepted);
+    }
+}
+
+TEST(Precedence, GrammarFileShouldRejectMisplacedDeclarations) {
+    EXPECT_THROW(GrammarFile::parse("S ::= E\nE ::= i\n%left E\n"), GrammarError);
+    EXPECT_THROW(GrammarFile::parse("S ::= E\nE ::= i %prec E\n"), GrammarError);
+    EXPECT_THROW(GrammarFile::parse("S ::= E\nE ::= i %prec\n"), GrammarError);
+    EXPECT_THROW(GrammarFile::parse("S ::= E\nE ::= i %prec + i\n"), GrammarError);
+    EXPECT_THROW(GrammarFile::parse("%prec +\nS ::= E\n"), GrammarError);
+    EXPECT_THROW(GrammarFile::parse("%left\nS ::= E\n"), GrammarError);
+    EXPECT_NO_THROW(GrammarFile::parse("%left '+'\nS ::= E\nE ::= E + E %prec '+' | i\n"));
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+#include <gmock/gmock.h>
+#include "../../src/Context.h"
+#include "../../src/GrammarFile.h"
+#include "../lua/ExpressionGrammar.h"
+#include "../lua/LuaGrammar.h"
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace testing;
+
+static vector<string> phaseNames(const Statistics &statistics) {
+    vector<string> result{};
+    for (auto &phase : statistics.phases()) {
+        result.push_back(phase.name + "@" + to_string(phase.depth));
+    }
+    return result;
+}
+
+TEST(Statistics, ShouldRecordEveryPhaseAndCountTheWork) {
+    auto context = GrammarFile::parse(expression).context();
+    context.first();
+    context.follow();
+    auto states = context.generalLr1();
+    context.table(states);
+    auto &statistics = context.getStatistics();
+    EXPECT_THAT(phaseNames(statistics), ElementsAre("first@0", "follow@0", "lr1@0", "closure@1", "table@0"));
+    for (auto &phase : statistics.phases()) {
+        EXPECT_GE(phase.milliseconds, 0);
+        EXPECT_GE(phase.start, 0);
+    }
+    EXPECT_LE(statistics.phases()[0].start, statistics.phases()[4].start);
+
+    auto &counters = statistics.counters();
+    // every state but the start one is found by a goto, the start state needs one more closure
+    EXPECT_EQ(counters.gotoCalls, states.size());
+    EXPECT_EQ(counters.closureCalls + counters.closureCacheHits, context.getClosureCache().hits() +
+                                                                 context.getClosureCache().misses());
+    EXPECT_GT(counters.closureCalls, 0);
+    EXPECT_GT(counters.fixpointIterations, 0);
+    EXPECT_GT(counters.dedupProbes, 0);
+    EXPECT_GT(counters.lookaheadMerges, 0);
+
+    context.clearStatistics();
+    EXPECT_TRUE(context.getStatistics().phases().empty());
+    EXPECT_EQ(context.getStatistics().counters().gotoCalls, 0);
+}
+
+TEST(Statistics, ANestedPhaseShouldBePartOfItsParent) {
+    auto context = GrammarFile::parse(expression).context();
+    // generalLr1() computes the first sets and prepares the closure engine on its own
+    auto states = context.generalLr1();
+    auto &phases = context.getStatistics().phases();
+    ASSERT_THAT(phaseNames(context.getStatistics()), ElementsAre("lr1@0", "first@1", "closure@1"));
+    EXPECT_LE(phases[1].milliseconds, phases[0].milliseconds);
+    EXPECT_LE(phases[0].start, phases[1].start);
+    EXPECT_DOUBLE_EQ(context.getStatistics().milliseconds("lr1"), phases[0].milliseconds);
+    EXPECT_DOUBLE_EQ(context.getStatistics().milliseconds("first"), 0);
+
+    // the parallel builder numbers the same states and finds them by the same goto work
+    auto parallel = GrammarFile::parse(expression).context();
+    auto parallelStates = parallel.generateLr1Parallel(2);
+    EXPECT_EQ(parallelStates.size(), states.size());
+    EXPECT_EQ(parallel.getStatistics().counters().gotoCalls, states.size());
+    EXPECT_GT(parallel.getStatistics().counters().closureCalls, 0);
+}
+
+TEST(Statistics, ShouldCountThePeakHeapOfAPhase) {
+    if (!Statistics::countsHeap()) {
+        GTEST_SKIP();
+    }
+    LuaGrammar lua{};
+    Context context{lua.productionList, lua.productionList[0]};
+    context.first();
+    auto states = context.generalLr1();
+    auto &phases = context.getStatistics().phases();
+    // first, lr1 and the closure preparation nested in it
+    ASSERT_EQ(phases.size(), 3);
+    // the states alone take more than a byte per item
+    size_t items = 0;
+    for (auto &state : states) {
+        items += state.ruleList().size();
+    }
+    EXPECT_GT(phases[1].peakBytes, items);
+    EXPECT_LT(phases[0].peakBytes, phases[1].peakBytes);
+
+    Statistics statistics{};
+    {
+        auto outer = statistics.phase("outer");
+        {
+            auto inner = statistics.phase("inner");
+            vector<char> block(1u << 20u, 1);
+        }
+        vector<char> smaller(1u << 10u, 1);
+    }
+    EXPECT_GE(statistics.phases()[1].peakBytes, 1u << 20u);
+    // the peak of the inner phase counts for the outer one too
+    EXPECT_GE(statistics.phases()[0].peakBytes, statistics.phases()[1].peakBytes);
+
+    // a phase of another Statistics started meanwhile does not measure the heap, nor reset the running peak
+    Statistics first{};
+    Statistics second{};
+    {
+        auto outer = first.phase("outer");
+        vector<char> block(1u << 20u, 1);
+        {
+            auto other = second.phase("other");
+            vector<char> smaller(1u << 10u, 1);
+        }
+    }
+    EXPECT_GE(first.phases()[0].peakBytes, 1u << 20u);
+    EXPECT_EQ(second.phases()[0].peakBytes, 0);
+    EXPECT_EQ(second.phases()[0].allocations, 0);
+    // and one started afterwards does again
+    {
+        auto other = second.phase("other");
+        vector<char> block(1u << 20u, 1);
+    }
+    EXPECT_GE(second.phases()[1].peakBytes, 1u << 20u);
+}
+
+TEST(Statistics, ShouldWriteJsonAndAChromeTrace) {
+    auto context = GrammarFile::parse(expression).context();
+    auto states = context.generalLr1();
+    context.table(states);
+    auto &statistics = context.getStatistics();
+    auto json = statistics.json();
+    EXPECT_THAT(json, HasSubstr("\"name\": \"lr1\", \"depth\": 0"));
+    EXPECT_THAT(json, HasSubstr("\"name\": \"first\", \"depth\": 1"));
+    EXPECT_THAT(json, HasSubstr("\"gotoCalls\": " + to_string(states.size())));
+    auto trace = statistics.chromeTrace();
+    EXPECT_THAT(trace, StartsWith("{\"displayTimeUnit\": \"ms\", \"traceEvents\": ["));
+    EXPECT_THAT(trace, HasSubstr("\"name\": \"table\", \"cat\": \"lr1\", \"ph\": \"X\""));
+    EXPECT_THAT(trace, HasSubstr("\"name\": \"counters\", \"ph\": \"C\""));
+
+    auto path = testing::TempDir() + "statistics.json";
+    statistics.writeJson(path);
+    ifstream in{path};
+    stringstream written{};
+    written << in.rdbuf();
+    EXPECT_EQ(written.str(), json);
+    ::remove(path.c_str());
+    EXPECT_THROW(statistics.writeChromeTrace("/nonexistent/directory/trace.json"), runtime_error);
+}
+
+int main(int argc, char *argv[]) {
+    InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}